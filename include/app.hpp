@@ -17,8 +17,11 @@
 #include "GLFW/glfw3.h"
 #include "world.hpp"
 #include <memory>
+#include <string>
 
+#include "frame_pacer.hpp"
 #include "registry.hpp"
+#include "simulation_thread.hpp"
 
 namespace cisalpine {
 
@@ -37,6 +40,13 @@ struct UILayout {
 
 enum class BrushShape { Circle, Square, Star };
 
+// Viewport camera over the world
+struct Camera {
+    float centerX = 0.0f; // World cell at the viewport center
+    float centerY = 0.0f;
+    float zoom = 1.0f;    // Screen pixels per world cell
+};
+
 class App {
 public:
     App() = default;
@@ -44,38 +54,69 @@ public:
 
     void init(int worldWidth, int worldHeight);
     void run();
+    // Run every benchmark scenario under each simulation engine and write the results as JSON.
+    // instrument adds per-step event counts (SimulationSettings::instrumentation).
+    void runBenchmark(const std::string& outputPath, bool instrument = false);
+    // Time every workgroup shape on the mixed benchmark scene, apply the fastest and
+    // cache them for this device so later launches start tuned.
+    void tuneWorkgroups();
     void shutdown();
 
 private:
     GLFWwindow* window = nullptr;
     std::unique_ptr<World> world;
+    SimulationThread simulation; // Steps the world; brushes, clears and settings go through it
+    SimulationSettings simulationSettings; // UI copy, submitted to the simulation on change
+    SimulationSettings submittedSettings;
 
     int worldWidth = 256;
     int worldHeight = 256;
     int pixelScale = 2;
 
+    // Largest viewport the window opens with; bigger worlds are viewed through the camera
+    static constexpr int MAX_VIEWPORT_WIDTH = 1280;
+    static constexpr int MAX_VIEWPORT_HEIGHT = 960;
+    static constexpr float MAX_ZOOM = 32.0f;
+
     UILayout layout;
+    Camera camera;
 
     // Timing
     float lastFrameTime = 0.0f;
 
+    // Frame pacing: UI copy of the frames-in-flight limit, applied between frames
+    FramePacer pacer;
+    int framesInFlight = 2;
+    double inputSampleTime = 0.0;    // When this frame's input was polled
+    double lastReflectedInput = 0.0; // Newest input the drawn world state already showed
+
     // Input state
     bool isDrawing = false;
     bool lastMousePressed = false; // for single click tracking
     int selectedElementId = 1;
     BrushShape selectedBrush = BrushShape::Circle;
     int brushSize = 3;
+    bool isPanning = false;
+    double panX = 0.0; // Cursor position at the last pan update
+    double panY = 0.0;
 
     // Logic
     Registry registry;
-    Shader brushShader;
 
     void calculateWindowSize(int& windowWidth, int& windowHeight);
     void updateLayout(int windowWidth, int windowHeight);
     void handleInput();
     void renderUI();
 
+    // Camera
+    void resetCamera();
+    void clampCamera();
+    void zoomCamera(float factor, double screenX, double screenY);
+    float fitZoom() const;
+    WorldView cameraView() const;
+
     // Convert screen coords to world coords
+    bool inViewport(double screenX, double screenY) const;
     bool screenToWorld(double screenX, double screenY, int& worldX, int& worldY);
 };
 
@@ -0,0 +1,88 @@
+/*
+* File: batch_world.hpp
+* Project: Cisalpine Engine
+* Author: Collin Longoria
+* Created on: 10/16/2026
+*
+* Copyright (c) 2025 Collin Longoria
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+
+#ifndef CISALPINE_BATCH_WORLD_HPP
+#define CISALPINE_BATCH_WORLD_HPP
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "shader.hpp"
+#include "workgroup.hpp"
+
+namespace cisalpine {
+
+// Many independent worlds of one size, stepped together for parameter sweeps.
+// Each world is a layer of a 2D texture array and a single 3D dispatch advances
+// all of them, so small worlds are no longer bound by per-dispatch overhead.
+// Movement uses the gather engine and nothing is rendered. As with World, the
+// element registry must be bound to SSBO 2.
+class BatchWorld {
+public:
+    BatchWorld(int width, int height, int count);
+    ~BatchWorld();
+
+    BatchWorld(const BatchWorld&) = delete;
+    BatchWorld& operator=(const BatchWorld&) = delete;
+
+    // workgroup: shape of the step dispatch, e.g. World's tuned Kernel::Simulation
+    bool init(const std::string& elementHeader, WorkgroupSize workgroup = DEFAULT_WORKGROUP);
+
+    // Advance every world by steps fixed timesteps
+    void step(int steps = 1);
+
+    // Worlds with equal seeds and contents evolve identically (default seed = world index)
+    void setSeed(int world, uint32_t seed);
+    void setSeeds(const std::vector<uint32_t>& seeds);
+
+    // Empty every world
+    void clear();
+    // Fill the cells [x0, x1) x [y0, y1) of one world with an element
+    void fill(int world, int x0, int y0, int x1, int y1, uint32_t element);
+    // Replace one world's cells: width * height RGBA8UI texels, rows bottom to top
+    void load(int world, const std::vector<uint8_t>& cells);
+
+    // Observation readbacks; both wait for the GPU
+    // One world's cells, in the layout load() takes
+    void observe(int world, std::vector<uint8_t>& cells) const;
+    // Per world: nonzero if anything changed (or could at random) during the last step()
+    void activity(std::vector<uint32_t>& changed) const;
+
+    int width() const { return worldWidth; }
+    int height() const { return worldHeight; }
+    int count() const { return worldCount; }
+    uint32_t steps() const { return frameCount; }
+
+private:
+    int worldWidth;
+    int worldHeight;
+    int worldCount;
+
+    // Double-buffered state arrays (RGBA8UI, one layer per world)
+    GLuint stateTextures[2] = {0, 0};
+    int currentBuffer = 0;
+
+    GLuint seedBuffer = 0;     // SSBO 9: one uint per world
+    GLuint activityBuffer = 0; // SSBO 8: one uint per world, reset by step()
+
+    uint32_t frameCount = 0;
+    float simulationTime = 0.0f;
+
+    Shader simulationShader;
+    WorkgroupSize stepGroup;
+};
+
+}
+
+#endif //CISALPINE_BATCH_WORLD_HPP
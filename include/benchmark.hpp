@@ -0,0 +1,78 @@
+/*
+* File: benchmark.hpp
+* Project: Cisalpine Engine
+* Author: Collin Longoria
+* Created on: 10/16/2026
+*
+* Copyright (c) 2025 Collin Longoria
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+
+#ifndef CISALPINE_BENCHMARK_HPP
+#define CISALPINE_BENCHMARK_HPP
+
+#include "world.hpp"
+#include "registry.hpp"
+
+#include <array>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace cisalpine {
+
+// A reproducible starting world, painted onto a cleared world
+struct BenchmarkScenario {
+    std::string name;
+    std::function<void(World&, const Registry&)> setup;
+};
+
+struct BenchmarkResult {
+    std::string scenario;
+    std::string engine;
+    int steps = 0;          // Steps until the world went idle (includes the settle window)
+    bool settled = false;   // False if the step limit ran out first
+    double gpuMsPerStep = 0.0;
+    // Margolus only: the reactions-only pass ahead of the block pass, included in gpuMsPerStep
+    double reactionGpuMsPerStep = 0.0;
+    double wallMs = 0.0;    // CPU wall time including glFinish each frame
+
+    // Cells per step in each SIM_COUNTER_NAMES category, when run instrumented
+    bool instrumented = false;
+    std::array<double, SIM_COUNTERS> eventsPerStep{};
+};
+
+// Sand drop, water fill and a mixed scene, scaled to the world size
+std::vector<BenchmarkScenario> benchmarkScenarios(int worldWidth, int worldHeight);
+
+// Run one scenario to rest (or maxSteps) under the given engine, instrumented if the
+// world's SimulationSettings::instrumentation is set.
+// frameCallback runs after every frame, e.g. to present progress.
+BenchmarkResult runBenchmark(World& world, const Registry& registry, const BenchmarkScenario& scenario,
+                             SimulationEngine engine, int maxSteps,
+                             const std::function<void()>& frameCallback = {});
+
+struct BatchBenchmarkResult {
+    int worlds = 0;
+    int worldSize = 0;
+    int steps = 0;          // Steps of every world; 0 if the batch could not be created
+    double wallMs = 0.0;
+    double worldStepsPerSecond = 0.0;
+};
+
+// Step a BatchWorld of worldSize^2 worlds, each a differently seeded mixed scene
+BatchBenchmarkResult runBatchBenchmark(const Registry& registry, int worldSize, int worlds, int steps,
+                                       WorkgroupSize workgroup = DEFAULT_WORKGROUP);
+
+const char* engineName(SimulationEngine engine);
+
+nlohmann::json toJson(const BenchmarkResult& result);
+nlohmann::json toJson(const BatchBenchmarkResult& result);
+
+}
+
+#endif //CISALPINE_BENCHMARK_HPP
@@ -0,0 +1,172 @@
+/*
+* File: frame_graph.hpp
+* Project: Cisalpine Engine
+* Author: Collin Longoria
+* Created on: 10/16/2026
+*
+* Copyright (c) 2025 Collin Longoria
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+
+#ifndef CISALPINE_FRAME_GRAPH_HPP
+#define CISALPINE_FRAME_GRAPH_HPP
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace cisalpine {
+
+// Storage for a transient texture. Transients with equal descriptions can share memory.
+struct TextureDesc {
+    int width = 0;
+    int height = 0;
+    GLenum format = GL_RGBA8;
+    GLint filter = GL_NEAREST;
+
+    bool operator==(const TextureDesc&) const = default;
+};
+
+// Handle to a texture or buffer declared for the current frame
+using FrameResource = int;
+
+// Per-frame list of compute passes that declare what they read and write.
+// Passes are recorded in order, then execute() binds each pass's declared images,
+// samplers and storage buffers, inserts a glMemoryBarrier only where an earlier pass
+// left a hazard on one of them, and backs transient textures with pooled textures
+// that are handed on once their last reader has run.
+//
+// Transient contents are undefined when a frame first writes them, and do not
+// survive to the next frame; anything that must persist is imported instead.
+// Pooled textures are ring-buffered by frame slot, so a frame never writes a
+// transient the GPU may still be reading for an earlier frame in flight.
+class FrameGraph {
+public:
+    FrameGraph() = default;
+    ~FrameGraph();
+
+    FrameGraph(const FrameGraph&) = delete;
+    FrameGraph& operator=(const FrameGraph&) = delete;
+
+    class PassBuilder {
+    public:
+        // Image unit binding (imageLoad / imageStore)
+        PassBuilder& read(GLuint unit, FrameResource texture, GLenum format, int level = 0);
+        PassBuilder& write(GLuint unit, FrameResource texture, GLenum format, int level = 0);
+        PassBuilder& readWrite(GLuint unit, FrameResource texture, GLenum format, int level = 0);
+        // Texture unit binding (texelFetch / texture)
+        PassBuilder& sample(GLuint unit, FrameResource texture);
+        // Shader storage binding
+        PassBuilder& storage(GLuint binding, FrameResource buffer, bool writes);
+
+        // Set uniforms and dispatch; bindings are already in place when this runs
+        void execute(std::function<void()> fn);
+
+    private:
+        friend class FrameGraph;
+        PassBuilder(FrameGraph& graph, int pass) : graph(graph), pass(pass) {}
+        FrameGraph& graph;
+        int pass;
+    };
+
+    // Forget last frame's passes and resources; pooled textures are kept.
+    // slot is the frame-in-flight index; transients only reuse textures from the same slot.
+    void beginFrame(int slot = 0);
+
+    FrameResource importTexture(const char* name, GLuint texture);
+    FrameResource importBuffer(const char* name, GLuint buffer);
+    FrameResource createTexture(const char* name, const TextureDesc& desc);
+
+    PassBuilder addPass(const char* name);
+
+    // Run the recorded passes, then make their writes visible to whatever follows the frame
+    void execute();
+
+    // The GL texture behind a resource. Transients only have one while execute() runs.
+    GLuint texture(FrameResource resource) const;
+
+    struct Stats {
+        int passes = 0;
+        int barriers = 0;
+        int transients = 0;      // Transient textures declared and used this frame
+        int pooledTextures = 0;  // Pooled textures backing them
+        size_t pooledBytes = 0;
+    };
+    const Stats& stats() const { return frameStats; }
+
+private:
+    // Pooled textures nobody used for this many frames are deleted
+    static constexpr int POOL_KEEP_FRAMES = 8;
+
+    enum class Usage { Image, Sampler, Storage };
+
+    struct Access {
+        FrameResource resource;
+        Usage usage;
+        GLuint unit;
+        GLenum format;
+        int level;
+        bool reads;
+        bool writes;
+    };
+
+    struct Resource {
+        std::string name;
+        bool buffer = false;
+        bool transient = false;
+        TextureDesc desc;
+        GLuint object = 0; // Imported object, or the pooled texture while execute() runs
+        int firstPass = -1;
+        int lastPass = -1;
+    };
+
+    struct Pass {
+        std::string name;
+        std::vector<Access> accesses;
+        std::function<void()> fn;
+    };
+
+    struct PooledTexture {
+        TextureDesc desc;
+        GLuint texture = 0;
+        int slot = 0;
+        bool inUse = false;
+        int idleFrames = 0;
+    };
+
+    // Hazard state of one buffer or texture level since it was last written
+    struct Hazard {
+        GLuint object = 0;
+        bool buffer = false;
+        int level = 0;
+        bool written = false;   // Written by an earlier pass
+        GLbitfield visible = 0; // Barrier bits issued since that write
+        bool read = false;      // Read by an earlier pass since the last barrier
+        GLbitfield writeBits = 0; // Bits that make the write visible to any later use
+    };
+
+    std::vector<Resource> resources;
+    std::vector<Pass> passes;
+    std::vector<PooledTexture> pool;
+    std::vector<Hazard> hazards;
+    Stats frameStats;
+    int frameSlot = 0;
+
+    PassBuilder& access(PassBuilder& builder, const Access& entry);
+    void allocateTransients(int pass);
+    void releaseTransients(int pass);
+    void trimPool();
+    Hazard& hazardFor(GLuint object, bool buffer, int level);
+    void barrierFor(const Pass& pass);
+    void bind(const Pass& pass) const;
+    static GLbitfield barrierBit(Usage usage);
+    static size_t bytesPerTexel(GLenum format);
+};
+
+}
+
+#endif //CISALPINE_FRAME_GRAPH_HPP
@@ -0,0 +1,82 @@
+/*
+* File: frame_pacer.hpp
+* Project: Cisalpine Engine
+* Author: Collin Longoria
+* Created on: 10/16/2026
+*
+* Copyright (c) 2025 Collin Longoria
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+
+#ifndef CISALPINE_FRAME_PACER_HPP
+#define CISALPINE_FRAME_PACER_HPP
+
+#include <glad/glad.h>
+#include <array>
+
+namespace cisalpine {
+
+// Caps how far the CPU runs ahead of the GPU.
+// Every frame is fenced after its swap, and beginFrame() waits on the fence of the
+// slot it is about to reuse, so at most framesInFlight frames are ever queued.
+// One in flight gives the lowest latency; more keep the GPU fed at the cost of
+// frames of delay.
+//
+// The same fences time input-to-photon latency: from when the newest input a frame
+// shows was sampled to when the GPU finished that frame. Presentation adds up to
+// one refresh on top, which GL cannot observe.
+class FramePacer {
+public:
+    static constexpr int MAX_FRAMES_IN_FLIGHT = 3;
+
+    FramePacer() = default;
+    ~FramePacer();
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    // Waits for every queued frame when the count changes
+    void setFramesInFlight(int count);
+    int framesInFlight() const { return frameCount; }
+
+    // Wait until the slot about to be reused has finished on the GPU, and return it.
+    // Per-frame resources indexed by the slot are then free to overwrite.
+    int beginFrame();
+
+    // Sample time (glfwGetTime) of input the current frame shows; the newest counts
+    void reflectInput(double time);
+
+    // Fence the frame's commands; call right after the swap
+    void endFrame();
+
+    // Wait for and delete every fence
+    void release();
+
+    struct Stats {
+        float waitMs = 0.0f;    // CPU time per frame blocked on the GPU
+        float latencyMs = 0.0f; // Input sample to GPU completion of the frame showing it
+    };
+    const Stats& stats() const { return frameStats; }
+
+private:
+    struct Frame {
+        GLsync fence = nullptr;
+        double inputTime = 0.0; // 0 = the frame showed no new input
+    };
+
+    std::array<Frame, MAX_FRAMES_IN_FLIGHT> frames;
+    int frameCount = 2;
+    int current = 0;
+    double pendingInput = 0.0;
+    Stats frameStats;
+
+    // Delete the frame's fence once it signals, recording its latency.
+    // Returns false if it is still pending and wait is false.
+    bool retire(Frame& frame, bool wait);
+};
+
+}
+
+#endif //CISALPINE_FRAME_PACER_HPP
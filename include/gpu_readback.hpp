@@ -0,0 +1,54 @@
+/*
+* File: gpu_readback.hpp
+* Project: Cisalpine Engine
+* Author: Collin Longoria
+* Created on: 10/16/2026
+*
+* Copyright (c) 2025 Collin Longoria
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+
+#ifndef CISALPINE_GPU_READBACK_HPP
+#define CISALPINE_GPU_READBACK_HPP
+
+#include <glad/glad.h>
+#include <vector>
+
+namespace cisalpine {
+
+// Non-blocking GPU -> CPU copies of a small buffer range.
+// Each request copies into one slot of a persistently mapped ring and drops a fence;
+// results are handed back in order once their fence has signalled, so the CPU
+// never waits on the GPU. Requests are dropped while every slot is in flight.
+class GpuReadback {
+public:
+    GpuReadback() = default;
+    ~GpuReadback();
+
+    GpuReadback(const GpuReadback&) = delete;
+    GpuReadback& operator=(const GpuReadback&) = delete;
+
+    bool init(GLsizeiptr size, int depth = 3);
+
+    // Queue a copy of [offset, offset + size) of buffer. Returns false if the ring is full.
+    bool request(GLuint buffer, GLintptr offset = 0);
+
+    // Copy the oldest finished result into dst. Returns false if none is ready yet.
+    bool poll(void* dst);
+
+    int pending() const { return pendingCount; }
+
+private:
+    GLuint ringBuffer = 0;
+    void* mapped = nullptr;
+    GLsizeiptr slotSize = 0;
+    std::vector<GLsync> fences;
+    int head = 0; // Next slot to write
+    int pendingCount = 0;
+};
+
+}
+
+#endif //CISALPINE_GPU_READBACK_HPP
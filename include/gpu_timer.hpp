@@ -0,0 +1,54 @@
+/*
+* File: gpu_timer.hpp
+* Project: Cisalpine Engine
+* Author: Collin Longoria
+* Created on: 10/16/2026
+*
+* Copyright (c) 2025 Collin Longoria
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+
+#ifndef CISALPINE_GPU_TIMER_HPP
+#define CISALPINE_GPU_TIMER_HPP
+
+#include <glad/glad.h>
+#include <vector>
+
+namespace cisalpine {
+
+// Non-blocking GPU timing of a span of commands.
+// begin()/end() drop timestamp queries into a small ring; poll() hands back
+// finished spans in order, so reading a timing never stalls the pipeline.
+class GpuTimer {
+public:
+    GpuTimer() = default;
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    bool init(int depth = 4);
+
+    // Delete the queries, dropping spans in flight. Query objects are not shared
+    // between contexts, so call this on the context that created them.
+    void release();
+
+    // Returns false (and times nothing) while every slot is still in flight
+    bool begin();
+    void end();
+
+    // Oldest finished span in milliseconds. Returns false if none is ready yet.
+    bool poll(double& milliseconds);
+
+private:
+    std::vector<GLuint> queries; // Pairs: [2 * slot] = start, [2 * slot + 1] = end
+    int head = 0; // Next slot to write
+    int pendingCount = 0;
+    bool open = false;
+};
+
+}
+
+#endif //CISALPINE_GPU_TIMER_HPP
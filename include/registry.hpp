@@ -37,7 +37,7 @@ struct GPUElementData {
     float lightRadius;      // 4 bytes  (offset 48) - radius of light emission
     float lightIntensity;   // 4 bytes  (offset 52) - intensity of light emission
     float ior;              // 4 bytes  (offset 56) - index of refraction (gemstones)
-    int _pad;               // 4 bytes  (offset 60) - pad to 64 bytes (multiple of 16)
+    int dispersion;         // 4 bytes  (offset 60) - max cells a liquid flows sideways per step
 };
 static_assert(sizeof(GPUElementData) == 64, "GPUElementData must be 64 bytes for std430");
 
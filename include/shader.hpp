@@ -43,12 +43,14 @@ public:
     void setUint(std::string_view name, uint32_t value) const;
     void setFloat(std::string_view name, float value) const;
     void setVec2(std::string_view name, float x, float y) const;
+    void setIVec2(std::string_view name, int x, int y) const;
     void setVec4(std::string_view name, float x, float y, float z, float w) const;
 
 private:
     GLuint programId = 0;
 
     static std::string readFile(std::string_view filePath);
+    static std::string resolveIncludes(const std::string& source, std::string_view path, int depth = 0);
     static GLuint compileShader(GLenum type, const std::string& source, std::string_view path);
     static bool checkCompileErrors(GLuint shader, std::string_view path);
     static bool checkLinkErrors(GLuint program);
@@ -0,0 +1,94 @@
+/*
+* File: simulation.hpp
+* Project: Cisalpine Engine
+* Author: Collin Longoria
+* Created on: 10/16/2026
+*
+* Copyright (c) 2025 Collin Longoria
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+
+#ifndef CISALPINE_SIMULATION_HPP
+#define CISALPINE_SIMULATION_HPP
+
+#include <glad/glad.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "registry.hpp"
+#include "world.hpp"
+
+namespace cisalpine {
+
+struct SimulationOptions {
+    int width = 256;
+    int height = 256;
+    std::string registryPath = "data/elements.json";
+    SimulationSettings settings;
+};
+
+// Headless entry point of cisalpine_core, for embedding simulations without the App.
+// Needs a current OpenGL 4.6 context, which the embedder creates however suits it
+// (a hidden window, an EGL pbuffer or surfaceless context) and hands to loadGL()
+// once per process. Shaders and the registry load relative to the working directory.
+//
+//   Simulation::loadGL(reinterpret_cast<GLADloadproc>(eglGetProcAddress));
+//   Simulation sim;
+//   sim.init({512, 512});
+//   sim.paint(256, 400, 20, 1, "Sand");
+//   sim.step(600);
+//   sim.queryRegion(0, 0, 512, 64, cells);
+//   sim.countElements(counts); // counts[sim.elementId("Sand")]
+//   sim.save("settled.cisw");
+//
+// Many Simulations can share one context and process; each owns its world's GL objects.
+class Simulation {
+public:
+    static bool loadGL(GLADloadproc loader);
+
+    Simulation() = default;
+
+    bool init(const SimulationOptions& options = SimulationOptions());
+
+    // Advance steps fixed timesteps (World::FIXED_TIMESTEP each)
+    void step(int steps = 1);
+
+    // Brush shapes: 0 circle, 1 square, 2 diamond. Returns false for unknown elements.
+    bool paint(int x, int y, int radius, int shape, const std::string& element);
+    void erase(int x, int y, int radius, int shape);
+    void clear();
+
+    // Cells [x, x + w) x [y, y + h), clipped to the world: RGBA8UI texels, rows bottom
+    // to top, element id in the first byte of each
+    void queryRegion(int x, int y, int w, int h, std::vector<uint8_t>& cells) const;
+
+    // Cells of each element in the whole world, indexed by element id
+    void countElements(ElementPopulation& counts) { worldPtr->countElements(counts); }
+
+    // Binary snapshot of the state and the element names it uses. Loading maps elements
+    // by name, so snapshots survive registry renumbering, and adopts the saved size.
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    int elementId(const std::string& name) const { return registryData.getId(name); }
+    int width() const { return worldPtr ? worldPtr->width() : 0; }
+    int height() const { return worldPtr ? worldPtr->height() : 0; }
+
+    // Full engine access, e.g. for rendering a snapshot
+    World& world() { return *worldPtr; }
+    const Registry& registry() const { return registryData; }
+
+private:
+    Registry registryData;
+    std::unique_ptr<World> worldPtr;
+    SimulationSettings settings;
+
+    bool createWorld(int width, int height);
+};
+
+}
+
+#endif //CISALPINE_SIMULATION_HPP
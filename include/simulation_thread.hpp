@@ -0,0 +1,82 @@
+/*
+* File: simulation_thread.hpp
+* Project: Cisalpine Engine
+* Author: Collin Longoria
+* Created on: 10/16/2026
+*
+* Copyright (c) 2025 Collin Longoria
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+
+#ifndef CISALPINE_SIMULATION_THREAD_HPP
+#define CISALPINE_SIMULATION_THREAD_HPP
+
+#include <glad/glad.h>
+#include "GLFW/glfw3.h"
+#include "registry.hpp"
+#include "spsc_queue.hpp"
+#include "world.hpp"
+
+#include <atomic>
+#include <thread>
+#include <variant>
+
+namespace cisalpine {
+
+// UI actions applied by whichever thread runs the simulation
+struct PaintCommand {
+    int x = 0;
+    int y = 0;
+    int radius = 0;
+    int shape = 0;
+    uint32_t element = 0;
+    bool erase = false;
+    double inputTime = 0.0; // When the brush input was sampled (glfwGetTime)
+};
+struct ClearCommand {};
+struct WakeCommand {};
+struct SettingsCommand {
+    SimulationSettings settings;
+};
+
+using SimulationCommand = std::variant<PaintCommand, ClearCommand, WakeCommand, SettingsCommand>;
+
+// Runs World::update() on its own thread with a hidden GLFW context sharing the main one.
+// The UI thread sends commands through a lock-free queue and keeps rendering whatever
+// state the simulation last handed over, so neither side waits for the other.
+// While not running, commands apply to the world immediately on the caller's thread.
+class SimulationThread {
+public:
+    SimulationThread() = default;
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    // Call from the main thread. Returns false (and stays inline) if no shared context is available.
+    bool start(GLFWwindow* mainWindow, World& world, const Registry& registry);
+    void stop();
+    bool running() const { return worker.joinable(); }
+
+    // Returns false if the queue was full and the command was dropped
+    bool submit(const SimulationCommand& command);
+
+private:
+    static constexpr size_t QUEUE_CAPACITY = 1024;
+
+    GLFWwindow* context = nullptr;
+    World* world = nullptr;
+    const Registry* registry = nullptr;
+    std::thread worker;
+    std::atomic<bool> quit{false};
+    SpscQueue<SimulationCommand, QUEUE_CAPACITY> commands;
+
+    void loop();
+    void apply(const SimulationCommand& command);
+};
+
+}
+
+#endif //CISALPINE_SIMULATION_THREAD_HPP
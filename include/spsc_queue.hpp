@@ -0,0 +1,59 @@
+/*
+* File: spsc_queue.hpp
+* Project: Cisalpine Engine
+* Author: Collin Longoria
+* Created on: 10/16/2026
+*
+* Copyright (c) 2025 Collin Longoria
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+
+#ifndef CISALPINE_SPSC_QUEUE_HPP
+#define CISALPINE_SPSC_QUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace cisalpine {
+
+// Lock-free single-producer single-consumer ring.
+// One thread only calls push(), one other thread only calls pop(). Each index is
+// written by its own side alone, so a release store / acquire load pair is enough.
+template<typename T, size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Returns false (and drops value) when the ring is full
+    bool push(const T& value) {
+        size_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail - headIndex.load(std::memory_order_acquire) == Capacity) return false;
+
+        slots[tail & (Capacity - 1)] = value;
+        tailIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Returns false when the ring is empty
+    bool pop(T& value) {
+        size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == tailIndex.load(std::memory_order_acquire)) return false;
+
+        value = slots[head & (Capacity - 1)];
+        headIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<T, Capacity> slots{};
+    // Separate cache lines so the producer and consumer do not contend
+    alignas(64) std::atomic<size_t> headIndex{0}; // Next slot to pop (consumer)
+    alignas(64) std::atomic<size_t> tailIndex{0}; // Next slot to push (producer)
+};
+
+}
+
+#endif //CISALPINE_SPSC_QUEUE_HPP
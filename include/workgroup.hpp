@@ -0,0 +1,70 @@
+/*
+* File: workgroup.hpp
+* Project: Cisalpine Engine
+* Author: Collin Longoria
+* Created on: 10/16/2026
+*
+* Copyright (c) 2025 Collin Longoria
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+
+#ifndef CISALPINE_WORKGROUP_HPP
+#define CISALPINE_WORKGROUP_HPP
+
+#include <glad/glad.h>
+#include <array>
+#include <string>
+
+namespace cisalpine {
+
+// Workgroup shape of a 2D compute kernel, injected into its shader as WG_X / WG_Y
+struct WorkgroupSize {
+    int x = 16;
+    int y = 16;
+
+    bool operator==(const WorkgroupSize&) const = default;
+};
+
+constexpr WorkgroupSize DEFAULT_WORKGROUP{16, 16};
+
+// Shapes the tuner tries; all are 64 or 256 invocations
+constexpr std::array<WorkgroupSize, 4> WORKGROUP_CANDIDATES = {{ {8, 8}, {16, 16}, {32, 8}, {64, 4} }};
+
+// Kernels whose shape is tuned per device. Every other 2D pass runs DEFAULT_WORKGROUP,
+// except lighting and the temporal tile passes, whose workgroups are the temporal tiles.
+enum class Kernel {
+    Simulation, // simulation.comp, including the reactions-only pass
+    Margolus,
+    Render,     // render.comp, color + normals and normals only
+    Composite,
+    Cascades,
+    Population
+};
+constexpr int KERNEL_COUNT = 6;
+constexpr const char* KERNEL_NAMES[KERNEL_COUNT] = {
+    "simulation", "margolus", "render", "composite", "cascades", "population"
+};
+
+using WorkgroupSizes = std::array<WorkgroupSize, KERNEL_COUNT>;
+
+inline WorkgroupSizes defaultWorkgroupSizes() {
+    WorkgroupSizes sizes;
+    sizes.fill(DEFAULT_WORKGROUP);
+    return sizes;
+}
+
+// Shader header lines for a shape
+inline std::string workgroupDefines(WorkgroupSize size) {
+    return "#define WG_X " + std::to_string(size.x) + "\n#define WG_Y " + std::to_string(size.y) + "\n";
+}
+
+// Workgroups covering count invocations along an axis of the given size
+inline GLuint workgroupCount(int count, int size) {
+    return static_cast<GLuint>((count + size - 1) / size);
+}
+
+}
+
+#endif //CISALPINE_WORKGROUP_HPP
@@ -0,0 +1,55 @@
+/*
+* File: workgroup_tuner.hpp
+* Project: Cisalpine Engine
+* Author: Collin Longoria
+* Created on: 10/16/2026
+*
+* Copyright (c) 2025 Collin Longoria
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+
+#ifndef CISALPINE_WORKGROUP_TUNER_HPP
+#define CISALPINE_WORKGROUP_TUNER_HPP
+
+#include <array>
+#include <functional>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "workgroup.hpp"
+
+namespace cisalpine {
+
+class World;
+
+struct WorkgroupTuning {
+    WorkgroupSizes sizes = defaultWorkgroupSizes();
+    // GPU time of each kernel's own dispatches under every WORKGROUP_CANDIDATES shape
+    // (< 0: failed to build or went untimed)
+    std::array<std::array<double, WORKGROUP_CANDIDATES.size()>, KERNEL_COUNT> candidateMs{};
+};
+
+// Vendor, renderer and driver version of the current context; tuned shapes are kept per device
+std::string deviceString();
+
+// Time each kernel's dispatches under every candidate shape and keep the fastest, one kernel
+// at a time. setup paints the scenario onto a cleared world before each measurement, and
+// only the tuned kernel's dispatches within the workload are timed (World::beginKernelTiming).
+// Renders into the bound framebuffer. Settings are restored and the world cleared after;
+// the shapes are left as tuned.
+WorkgroupTuning tuneWorkgroups(World& world, const std::function<void(World&)>& setup);
+
+// Shapes cached per deviceString() in a JSON file. load returns false when the file
+// has no entry for the device; save keeps the other devices' entries.
+bool loadWorkgroupCache(const std::string& path, const std::string& device, WorkgroupSizes& sizes);
+bool saveWorkgroupCache(const std::string& path, const std::string& device, const WorkgroupSizes& sizes);
+
+// {"simulation": [16, 16], ...}
+nlohmann::json toJson(const WorkgroupSizes& sizes);
+
+}
+
+#endif //CISALPINE_WORKGROUP_TUNER_HPP
@@ -13,17 +13,105 @@
 #ifndef CISALPINE_WORLD_HPP
 #define CISALPINE_WORLD_HPP
 #include <glad/glad.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
 
+#include "frame_graph.hpp"
+#include "gpu_readback.hpp"
+#include "gpu_timer.hpp"
 #include "shader.hpp"
+#include "workgroup.hpp"
 #include <glm/glm.hpp>
 
 namespace cisalpine {
 
+// Cellular update rule used for movement
+enum class SimulationEngine {
+    Gather,   // Every cell picks the neighbour that wins the move into it
+    Margolus  // Alternating 2x2 blocks rearranged in place, after a reactions-only pass
+};
+
 // Simulation settings
 struct SimulationSettings {
+    SimulationEngine engine = SimulationEngine::Gather;
+
     // Simulation loops per frame
     int stepsPerFrame = 4;
+
+    // Stop simulating and re-rendering once nothing has moved for settleFrames readbacks
+    bool idleWhenSettled = true;
+    int settleFrames = 30;
+
+    // Step governor: cap steps so measured simulation + render GPU time fits frameBudgetMs.
+    // Time the capped steps would have covered is dropped and counted as debt.
+    bool stepGovernor = true;
+    float frameBudgetMs = 12.0f;
+    bool degradeLighting = false; // Coarser lighting while the simulation falls behind
+
+    // Count cells per element after each frame's steps (read back a few frames late)
+    bool populationStats = true;
+
+    // Step with the SIM_INSTRUMENTATION shader variants, which count what cells did
+    bool instrumentation = false;
+
+    // Also count changed cells per dirty tile into the activity heat map
+    // (instrumented variants; drawn by RenderSettings::activityOverlay)
+    bool tileActivity = false;
+
+    bool operator==(const SimulationSettings&) const = default;
+};
+
+// One count per possible element id (the state's 8-bit R channel)
+constexpr int POPULATION_BINS = 256;
+using ElementPopulation = std::array<uint32_t, POPULATION_BINS>;
+
+// Categories counted by SIM_INSTRUMENTATION builds of the step shaders (COUNTER_* in sim_common.glsl)
+constexpr int SIM_COUNTERS = 5;
+constexpr const char* SIM_COUNTER_NAMES[SIM_COUNTERS] = { "moved", "reacted", "burned", "decayed", "grew" };
+
+// GPU timings and governor state, averaged over recent frames
+struct SimulationStats {
+    float stepMs = 0.0f;      // GPU time per simulation step
+    float reactionMs = 0.0f;  // Of which the Margolus engine's reactions-only pass
+    float renderMs = 0.0f;    // GPU time of the render passes
+    int stepsLastFrame = 0;
+    int stepLimit = 0;        // Governor cap for the next frame (0 = uncapped)
+    float debtSeconds = 0.0f; // Simulation time dropped by the governor
+    int lightingDegrade = 0;  // 0 = full quality, each level halves resolution and drops a bounce
+    float renderScale = 1.0f; // Display resolution relative to the world
+
+    // Cells per element id as of the last population readback
+    ElementPopulation population{};
+
+    // Cells per step in each SIM_COUNTER_NAMES category (while instrumented)
+    std::array<float, SIM_COUNTERS> eventsPerStep{};
+
+    // Running totals over every timed step, for benchmarks
+    double timedStepMs = 0.0;
+    long long timedSteps = 0;
+    double timedReactionMs = 0.0; // Sampled reaction passes (Margolus only)
+    long long timedReactionPasses = 0;
+    std::array<double, SIM_COUNTERS> countedEvents{};
+    long long countedSteps = 0;
+};
+
+// Debug overlay of per-tile simulation activity, from SimulationSettings::tileActivity
+enum class ActivityOverlay {
+    Off,
+    Heat,         // Changed cells per step, peaks fading over a few seconds
+    ChangedTiles  // Tiles any step changed last frame, i.e. all a tile scheduler would run
+};
+
+// Global illumination model used to fill the lightmap
+enum class LightingModel {
+    Bounce,           // Local emitter gather + neighbour bounce passes
+    RadianceCascades  // Multi-resolution probe hierarchy, long-range occluded GI
 };
 
 // Rendering Settings
@@ -35,6 +123,69 @@ struct RenderSettings {
     float ambientLight = 0.15f;
     float specularStrength = 0.6f;
     int lightBounces = 3;
+
+    LightingModel lightingModel = LightingModel::Bounce;
+    int cascadeCount = 0;         // 0 = enough cascades to span the world diagonal
+    float cascadeInterval = 2.0f; // Ray length of cascade 0 in pixels
+    float cascadeEmission = 6.0f; // Radiance scale of emitters under radiance cascades
+
+    float lightingScale = 1.0f;   // Lightmap resolution relative to the world (1, 1/2, 1/4)
+    bool occupancySkipping = true; // Skip empty space in light ray-marches via the occupancy pyramid
+
+    bool shadowMaps = false;      // Polar shadow maps for the strongest lights (bounce model)
+    int shadowMapLights = 8;      // How many of the brightest lights get a shadow map
+
+    bool fusedComposite = true;    // Evaluate color/normals in the composite pass, no intermediate textures
+
+    bool compactLightmaps = false; // R11F_G11F_B10F lightmaps instead of RGBA16F
+    bool packedNormals = false;    // Octahedral normal + specular in RGBA8 instead of RGBA16F
+    bool compactDisplay = false;   // RGB10_A2 display target instead of RGBA8
+
+    bool dirtyTracking = false;    // Re-render only tiles the simulation changed (bounce model, no temporal)
+    bool animatedEffects = true;   // Time-driven shimmer/sparkle/flicker; forces full redraws under dirtyTracking
+
+    bool temporalLighting = false; // Amortize the bounce solve over several frames (bounce model)
+    int temporalSlices = 4;        // Each tile is relit once every temporalSlices frames
+    float temporalBlend = 0.5f;    // Weight of a relit tile against its history
+
+    bool dynamicResolution = false; // Shade a scaled-down sampling of the world to hold targetFrameMs
+    float targetFrameMs = 16.0f;    // GPU time per frame, simulation included
+    float minRenderScale = 0.5f;
+
+    bool overviewRendering = true; // Composite a majority-element pyramid level when zoomed far out
+    bool minimap = true;
+
+    ActivityOverlay activityOverlay = ActivityOverlay::Off; // Redraws every frame while on
+};
+
+// GPU memory held by a world's textures and buffers, in bytes
+struct MemoryUsage {
+    size_t state = 0;         // Double-buffered element state
+    size_t renderTargets = 0; // Color + normal intermediates
+    size_t lightmaps = 0;     // Lightmap, ping-pong and temporal history
+    size_t display = 0;       // Display, overview pyramid and minimap
+    size_t lighting = 0;      // Occupancy pyramid, shadow maps, buffers
+    size_t transient = 0;     // Frame graph pool: cascades, and color/normals/ping-pong when nothing persists
+
+    size_t total() const { return state + renderTargets + lightmaps + display + lighting + transient; }
+};
+
+// World-space rectangle shown in the viewport, in cells (y up). Empty = the whole world.
+struct WorldView {
+    float x = 0.0f;
+    float y = 0.0f;
+    float width = 0.0f;
+    float height = 0.0f;
+};
+
+// Half-open rectangle of world cells
+struct CellRect {
+    int x0 = 0;
+    int y0 = 0;
+    int x1 = 0;
+    int y1 = 0;
+
+    bool operator==(const CellRect&) const = default;
 };
 
 class World {
@@ -45,12 +196,52 @@ public:
     World(const World&) = delete;
     World& operator=(const World&) = delete;
 
-    bool init(const std::string& shaderHeader);
+    static constexpr float FIXED_TIMESTEP = 1.0f / 60.0f; // 60 sim steps / second
+
+    bool init(const std::string& elementHeader);
     void update(float dt);
-    void render(int screenX, int screenY, int screenWidth, int screenHeight);
+    void render(int screenX, int screenY, int screenWidth, int screenHeight, const WorldView& view = WorldView());
+
+    // Frame-in-flight slot of the next render(); transient textures are ring-buffered per slot
+    void setFrameSlot(int slot) { frameSlot = slot; }
 
     void clear();
 
+    // Run exactly steps fixed timesteps now, bypassing the step governor and idle detection
+    void step(int steps);
+
+    // Stamp a brush into the current state (shape: 0 circle, 1 square, 2 diamond)
+    void paint(int x, int y, int radius, int shape, uint32_t element, bool erase);
+
+    // Copy cells [x, x + w) x [y, y + h) out of / into the current state
+    // (RGBA8UI texels, rows bottom to top). Both are blocking transfers.
+    void readCells(int x, int y, int w, int h, std::vector<uint8_t>& cells) const;
+    void writeCells(int x, int y, int w, int h, const std::vector<uint8_t>& cells);
+
+    // Cells per element id in the current state. Blocking; update() reads the same
+    // counts back asynchronously into SimulationStats::population.
+    void countElements(ElementPopulation& counts);
+
+    // Input latency: update() side notes when input it applied was sampled (glfwGetTime),
+    // render() side reports the newest such time the drawn state reflects
+    void markInput(double time) { inputTime = std::max(inputTime, time); }
+    double reflectedInputTime() const { return shownInputTime; }
+
+    // Settled worlds skip simulation and rendering until woken by input or a setting change
+    bool isIdle() const { return idle.load(std::memory_order_relaxed); }
+    void wake();
+
+    // Threaded simulation: update(), paint() and clear() run on another thread with a
+    // context sharing this one, and render() draws the latest state update() handed over.
+    // Toggle only while no simulation thread is running.
+    void setThreaded(bool enabled);
+    bool isThreaded() const { return threaded; }
+
+    // Per-context simulation objects (the step timer's queries). Release on the old
+    // context before moving update() to another thread, then attach on the new one.
+    void attachSimulationContext();
+    void releaseSimulationContext();
+
     int width() const { return worldWidth; }
     int height() const { return worldHeight; }
 
@@ -58,12 +249,39 @@ public:
     GLuint getCurrentTexture() const { return stateTextures[currentBuffer]; }
     GLuint getDisplayTexture() const { return displayTexture; }
 
+    // Whole-world overview in flat element colors (RGBA8, y up)
+    GLuint getMinimapTexture() const { return minimapTexture; }
+    int getMinimapWidth() const { return minimapWidth; }
+    int getMinimapHeight() const { return minimapHeight; }
+
     RenderSettings& renderSettings() { return renderSettingsData; }
     const RenderSettings& renderSettings() const { return renderSettingsData; }
 
+    // Memory with the active formats, and what the same allocations take at the default formats
+    MemoryUsage memoryUsage() const;
+    MemoryUsage uncompactedMemoryUsage() const;
+
     SimulationSettings& simulationSettings() { return simSettings; }
     const SimulationSettings& simulationSettings() const { return simSettings; }
 
+    // As of the last state render() picked up (or the last update() when not threaded)
+    const SimulationStats& simulationStats() const { return shownStats; }
+
+    // Workgroup shapes of the tuned kernels (see workgroup_tuner.hpp). Setting them
+    // recompiles the affected shaders; on failure the previous shapes stay in use.
+    const WorkgroupSizes& workgroupSizes() const { return workgroups; }
+    bool setWorkgroupSize(Kernel kernel, WorkgroupSize size);
+    bool setWorkgroupSizes(const WorkgroupSizes& sizes);
+
+    // GPU time of one kernel's own dispatches, for the tuner: between begin and end every
+    // dispatch of that kernel is bracketed by timestamp queries. end waits for the GPU and
+    // returns the summed milliseconds, or -1 if the kernel never ran or a span was dropped.
+    void beginKernelTiming(Kernel kernel);
+    double endKernelTiming();
+
+    // Passes, barriers and transients of the last rendered frame
+    const FrameGraph::Stats& frameGraphStats() const { return frameGraph.stats(); }
+
 private:
     int worldWidth;
     int worldHeight;
@@ -72,7 +290,6 @@ private:
     float accumulatedTime = 0.0f;
     float simulationTime = 0.0f;
     uint32_t frameCount = 0;
-    static constexpr float FIXED_TIMESTEP = 1.0f / 60.0f; // 60 sim steps / second
 
     // Double-buffered state textures (RGBA8UI)
     // R = element, G = life/state, B = velocity/misc, A = flags
@@ -80,32 +297,295 @@ private:
     int currentBuffer = 0;
 
     // Rendering textures
+    // Color, normal and ping-pong textures only persist while dirty-tile rendering can
+    // reuse them; otherwise the frame graph hands out transients (see updateRenderTargets)
     GLuint colorTexture = 0; // Raw element colors (RGBA8)
-    GLuint normalTexture = 0; // Per-pixel normals (RGBA16F: xy=normal, z=height, w=specular)
+    GLuint normalTexture = 0; // Per-pixel normals (RGBA16F: xyz=normal, w=specular)
     GLuint lightmapTexture = 0; // Accumulated light (RGBA16F: rgb=light color, a=intensity)
     GLuint lightmapPingPong = 0; // Ping-pong for light propagation
-    GLuint displayTexture = 0; // Final composited output (RGBA8)
+    int lightmapWidth = 0; // Lightmaps are world size / lightingDownsample
+    int lightmapHeight = 0;
+    int lightingDownsample = 1;
+    GLuint displayTexture = 0; // Final composited output (RGBA8 or RGB10_A2)
+
+    // Active render-target formats, switched by the RenderSettings format flags.
+    // Shaders see them as LIGHTMAP_FORMAT / NORMAL_FORMAT / DISPLAY_FORMAT.
+    GLenum lightmapFormat = GL_RGBA16F;
+    GLenum normalFormat = GL_RGBA16F;
+    GLenum displayFormat = GL_RGBA8;
+    std::string shaderHeader; // Element registry + engine constants
+    WorkgroupSizes workgroups = defaultWorkgroupSizes();
+
+    // Radiance cascades (RGBA16F transients, merged from the top cascade down)
+    // Padded so every cascade's probe grid divides the texture evenly
+    static constexpr int MAX_CASCADES = 6;
+    int cascadeWidth = 0;
+    int cascadeHeight = 0;
+
+    // Occupancy pyramid (RG16F: r = max opacity, g = min opacity per block)
+    // Padded so each level is exactly half the one below
+    static constexpr int MAX_OCCUPANCY_LEVELS = 6;
+    GLuint occupancyTexture = 0;
+    int occupancyLevels = 0;
+    int occupancyWidth = 0;
+    int occupancyHeight = 0;
+
+    // Polar shadow maps
+    // Strong emitters are grouped per LIGHT_BLOCK_SIZE^2 block into candidate lights,
+    // the brightest MAX_SHADOW_LIGHTS get one row of SHADOW_MAP_RESOLUTION angle bins
+    static constexpr int MAX_SHADOW_LIGHTS = 16;
+    static constexpr int SHADOW_MAP_RESOLUTION = 512;
+    static constexpr int MAX_LIGHT_CANDIDATES = 1024;
+    static constexpr int LIGHT_BLOCK_SIZE = 8;
+    static constexpr int SHADOW_LIGHT_STRIDE = 48; // sizeof(ShadowLight) in std430
+    GLuint shadowMapTexture = 0; // R32F: nearest occluder distance per (angle, light)
+    GLuint shadowLightBuffer = 0; // SSBO: counts + selected lights
+    GLuint lightCandidateBuffer = 0; // SSBO: candidate lights
+
+    // Temporal lighting
+    // Tiles are TEMPORAL_TILE_SIZE^2 lightmap texels, one lighting workgroup each
+    static constexpr int TEMPORAL_TILE_SIZE = 16;
+    static constexpr int MAX_TEMPORAL_SLICES = 16;
+    GLuint lightHistoryTexture = 0; // RGBA16F: accumulated lightmap
+    GLuint temporalTileBuffer = 0; // SSBO: per-tile signature + changed flag
+    int temporalTilesX = 0;
+    int temporalTilesY = 0;
+    int temporalFrame = 0;
+    bool temporalHistoryValid = false;
+    RenderSettings temporalSettings; // Settings the history was lit with
+
+    // Dirty tiles (one bit per DIRTY_TILE_SIZE^2 world cells)
+    // The simulation and brush OR changed tiles into dirtyTileBuffer between frames;
+    // render dilates them by the light reach into renderTileBuffer and skips clean tiles.
+    static constexpr int DIRTY_TILE_SIZE = 16;
+    GLuint dirtyTileBuffer = 0;
+    GLuint renderTileBuffer = 0;
+    int dirtyTilesX = 0;
+    int dirtyTilesY = 0;
+    bool displayValid = false; // displayTexture/lightmaps hold a complete frame for displaySettings
+    RenderSettings displaySettings;
+
+    // Idle detection
+    // Each frame's steps bump activityBuffer when any cell changes; the value is read
+    // back a few frames later without stalling and counted towards settleFrames.
+    GLuint activityBuffer = 0;
+    GpuReadback activityReadback;
+    int quietReadbacks = 0;
+    std::atomic<bool> idle{false};
+
+    // Instrumentation counters (SIM_COUNTERS uints, reset before each frame's steps)
+    GLuint simCounterBuffer = 0;
+    GpuReadback simCounterReadback;
+    std::deque<int> countedStepCounts; // Steps in each in-flight readback, oldest first
+
+    // Activity heat map (one RG16F texel per dirty tile)
+    // Instrumented steps add changed cells per tile into tileChangeBuffer; each update that
+    // stepped folds them into activityHeatTexture, whose peaks halve every HEAT_HALF_LIFE
+    // seconds. A settled world keeps fading them for HEAT_FADE_TIME, then stops folding.
+    static constexpr float HEAT_HALF_LIFE = 1.0f;
+    static constexpr float HEAT_FADE_TIME = 8.0f * HEAT_HALF_LIFE;
+    GLuint tileChangeBuffer = 0;
+    GLuint activityHeatTexture = 0;
+    float heatElapsed = 0.0f; // Seconds since the last fold
+    float heatQuietTime = 0.0f; // Seconds folded without steps
+    bool heatFolded = false; // Unthreaded: heat changed since render() last drew
+
+    // Element histogram (POPULATION_BINS uints, rebuilt after each frame's steps)
+    GLuint populationBuffer = 0;
+    GpuReadback populationReadback;
+
+    // Margolus block rules (1 << MARGOLUS_RULE_BITS bytes, built once in init)
+    GLuint margolusRuleBuffer = 0;
+
+    // Kernel timing (beginKernelTiming); finished spans are summed as new ones open
+    static constexpr int KERNEL_TIMER_DEPTH = 64;
+    GpuTimer kernelTimer;
+    int timedKernel = -1;
+    int kernelSpans = 0;
+    double kernelMs = 0.0;
+    bool kernelSpanDropped = false;
+
+    // Threaded simulation
+    // update() copies each changed state into the back slot and swaps it with the middle
+    // one; render() swaps a fresh middle slot with its front slot. Fences order the copy
+    // before the renderer's reads, and those reads before the slot is written again.
+    struct PublishedState {
+        GLuint texture = 0;
+        GLuint heat = 0; // Activity heat map, copied under the same fence
+        GLsync written = nullptr; // Copy into texture (waited on by the renderer)
+        GLsync read = nullptr;    // Renderer's last use (waited on before the next copy)
+        float time = 0.0f;
+        double inputTime = 0.0;
+        SimulationStats stats;
+    };
+    static constexpr int FRESH_SLOT = 4; // Set on publishMiddle until render() takes it
+    bool threaded = false;
+    bool stateChanged = false; // Something to publish since the last handover
+    std::array<PublishedState, 3> published;
+    int publishBack = 0;
+    std::atomic<int> publishMiddle{1};
+    int publishFront = 2;
+
+    // Step governor
+    // Steps and render passes are bracketed by timestamp queries read back a few frames late.
+    static constexpr int MAX_LIGHTING_DEGRADE = 2;
+    GpuTimer stepTimer;
+    GpuTimer renderTimer;
+    std::deque<int> timedStepCounts; // Steps in each in-flight stepTimer span, oldest first
+    GpuTimer reactionTimer; // The first Margolus reaction pass of each frame
+    bool timeReactionPass = false;
+    SimulationStats stats; // Owned by update()
+    SimulationStats shownStats; // Owned by render(): stats as of the drawn state, plus renderMs/renderScale
+    float shownTime = 0.0f; // simulationTime as of the drawn state
+    double inputTime = 0.0; // Owned by update(): newest input applied, see markInput()
+    double shownInputTime = 0.0;
+    std::atomic<float> governorRenderMs{0.0f}; // Smoothed render time for stepLimit()
+    int behindFrames = 0; // Consecutive frames the governor dropped time
+    int caughtUpFrames = 0;
+
+    // Dynamic resolution
+    // The composite shades the renderWidth x renderHeight corner of displayTexture,
+    // the blit stretches that corner over the screen.
+    int renderWidth = 0;
+    int renderHeight = 0;
+    int framesSinceRescale = 0;
+
+    // Camera culling
+    // Pass 1 and the bounce passes cover litCells (visible plus light reach),
+    // the composite only visibleCells. Dispatches start at a 16-aligned origin.
+    CellRect visibleCells;
+    CellRect litCells;
+
+    // Overview pyramid (RGBA8UI, level L = mip L - 1: majority element of each 2^L block)
+    // Zoomed out past 2 cells per screen pixel, the composite reads level overviewLevel
+    // instead of the state, so its cost follows screen pixels rather than world cells.
+    static constexpr int MAX_OVERVIEW_LEVELS = 5;
+    static constexpr int MINIMAP_SIZE = 176;
+    GLuint overviewTexture = 0;
+    int overviewLevels = 0;
+    int overviewWidth = 0;
+    int overviewHeight = 0;
+    int overviewLevel = 0;
+    GLuint minimapTexture = 0;
+    int minimapWidth = 0;
+    int minimapHeight = 0;
+    int minimapLevel = 1;
 
     // Shaders
     Shader simulationShader;
+    Shader reactionShader; // simulation.comp with REACTIONS_ONLY, ahead of the Margolus pass
+    Shader margolusShader; // Margolus block movement
+    Shader instrumentedSimulationShader; // SIM_INSTRUMENTATION variants of the three above
+    Shader instrumentedReactionShader;
+    Shader instrumentedMargolusShader;
     Shader renderShader; // Takes sim state and creates color + normals
+    Shader normalShader; // render.comp with NORMALS_ONLY, for bounce lighting under the fused composite
     Shader lightingShader; // Light propagation and accumulation
-    Shader compositeShader; // Final composition
+    Shader cascadeShader; // Radiance cascades GI
+    Shader occupancyShader; // Max/min opacity pyramid
+    Shader shadowGatherShader; // Strong emitters -> candidate lights
+    Shader shadowSelectShader; // Brightest candidates -> shadow-mapped lights
+    Shader shadowMapShader; // Polar occluder depth per light
+    Shader temporalTilesShader; // Per-tile change detection
+    Shader temporalResolveShader; // Blend relit tiles into the history
+    Shader compositeShader; // Final composition from color + normal textures
+    Shader fusedCompositeShader; // Final composition evaluating color + normals inline
     Shader quadShader; // Blit to screen
+    Shader brushShader; // Paint elements into the state
+    Shader dirtyDilateShader; // Dirty tiles -> tiles to re-render
+    Shader stateDownsampleShader; // Overview pyramid levels
+    Shader minimapShader; // Overview level -> minimap colors
+    Shader activityHeatShader; // Tile change counts -> activity heat map
+    Shader overlayCompositeShader; // ACTIVITY_OVERLAY variants of the two composites
+    Shader fusedOverlayCompositeShader;
+    Shader populationShader; // Cells per element
 
     // Quad for rendering
     GLuint quadVAO = 0;
     GLuint quadVBO = 0;
 
+    // Render passes of the current frame; barriers and transients follow from what they declare
+    FrameGraph frameGraph;
+    int frameSlot = 0;
+    struct FrameTargets {
+        FrameResource state = -1;
+        FrameResource color = -1;
+        FrameResource normal = -1;
+        FrameResource lightmap = -1;
+        FrameResource lightmapPingPong = -1;
+        FrameResource lightHistory = -1;
+        FrameResource display = -1;
+        FrameResource occupancy = -1;
+        FrameResource overview = -1;
+        FrameResource minimap = -1;
+        FrameResource shadowMap = -1;
+        FrameResource shadowLights = -1;
+        FrameResource lightCandidates = -1;
+        FrameResource temporalTiles = -1;
+        FrameResource activityHeat = -1;
+    } targets;
+
     // Settings
     RenderSettings renderSettingsData;
     SimulationSettings simSettings;
 
     // Helpers
     void createTextures();
+    void createLightmaps(int downsample);
+    void updateRenderTargets(bool persistent, bool needColor, bool needNormals);
+    bool persistentTargets() const;
+    void createDisplayTexture();
+    bool loadStepShaders();
+    bool loadFormatShaders();
+    WorkgroupSize workgroup(Kernel kernel) const { return workgroups[static_cast<int>(kernel)]; }
+    void applyRenderFormats();
+    MemoryUsage computeMemoryUsage(GLenum lightmap, GLenum normal, GLenum display) const;
+    bool prepareDirtyTiles();
+    void renderFrame(bool fused, bool needNormals, bool dirtyOnly);
+    void declareFrameTargets(bool needColor, bool needNormals);
+    void pollActivity();
+    void dispatchPopulation();
+    void pollStepTimer();
+    void pollSimCounters();
+    void requestSimCounters(int steps);
+    void updateActivityHeat(int steps, float dt);
+    bool instrumentedSteps() const;
+    int stepLimit() const;
+    void updateLightingDegrade(bool fellBehind);
+    int bounceCount() const;
+    void updateRenderScale();
+    void setRenderScale(float scale);
+    void updateOverviewLevel(const WorldView& view, int screenWidth);
+    float compositeScale() const;
+    void updateRenderSize();
+    void buildOverview(int levels);
+    void renderMinimap();
+    void updateCulling(const WorldView& view);
+    void dispatchRegion(const Shader& shader, WorkgroupSize size, int x0, int y0, int x1, int y1) const;
+    void dispatchRegion(const Shader& shader, Kernel kernel, int x0, int y0, int x1, int y1);
+    void dispatchKernel(Kernel kernel, GLuint groupsX, GLuint groupsY);
+    bool beginKernelSpan(Kernel kernel);
+    float renderTime() const;
+    float lightReach() const;
     void createQuad();
     void swapBuffers();
     void simulationStep();
+    void simulationPass(const Shader& shader, Kernel kernel, GLuint groupsX, GLuint groupsY); // One dispatch + buffer swap
+    bool tracksDirtyTiles() const;
+    GLuint renderState() const; // State texture the render passes read
+    GLuint renderHeat() const;  // Activity heat map the composite overlay reads
+    void publishState();
+    bool acquireState();
+    void releaseState();
+    void showStats(const SimulationStats& source, float time, double input);
+    void pollRenderTimer();
+    FrameResource renderBounceLighting(bool dirtyOnly);
+    void renderShadowMaps();
+    void updateTemporalTiles(bool reset, int dilation);
+    FrameResource resolveTemporalLighting(FrameResource freshLightmap, bool reset, int dilation);
+    void buildOccupancy();
+    FrameResource renderRadianceCascades();
+    int resolveCascadeCount() const;
 };
 
 }
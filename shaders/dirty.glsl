@@ -0,0 +1,39 @@
+// Dirty tile bitmask: one bit per DIRTY_TILE_SIZE x DIRTY_TILE_SIZE block of world cells.
+// The simulation and brush OR bits in as cells change; render passes test the
+// dilated mask and skip workgroups whose area is clean.
+
+layout(std430, binding = 6) buffer DirtyTiles {
+    uint dirtyBits[];
+};
+
+ivec2 dirtyTileCount(ivec2 worldSize) {
+    return (worldSize + DIRTY_TILE_SIZE - 1) / DIRTY_TILE_SIZE;
+}
+
+void markDirty(ivec2 cell, ivec2 worldSize) {
+    ivec2 tile = cell / DIRTY_TILE_SIZE;
+    uint index = uint(tile.y * dirtyTileCount(worldSize).x + tile.x);
+    uint bit = 1u << (index & 31u);
+    // Plain read first: most changed cells land in tiles that are already marked
+    if ((dirtyBits[index >> 5] & bit) == 0u) {
+        atomicOr(dirtyBits[index >> 5], bit);
+    }
+}
+
+bool tileDirty(ivec2 tile, ivec2 tileCount) {
+    uint index = uint(tile.y * tileCount.x + tile.x);
+    return (dirtyBits[index >> 5] & (1u << (index & 31u))) != 0u;
+}
+
+// Any dirty tile overlapping the inclusive cell range
+bool regionDirty(ivec2 cellMin, ivec2 cellMax, ivec2 worldSize) {
+    ivec2 tileCount = dirtyTileCount(worldSize);
+    ivec2 lo = clamp(cellMin / DIRTY_TILE_SIZE, ivec2(0), tileCount - 1);
+    ivec2 hi = clamp(cellMax / DIRTY_TILE_SIZE, ivec2(0), tileCount - 1);
+    for (int y = lo.y; y <= hi.y; y++) {
+        for (int x = lo.x; x <= hi.x; x++) {
+            if (tileDirty(ivec2(x, y), tileCount)) return true;
+        }
+    }
+    return false;
+}
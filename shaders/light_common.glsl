@@ -0,0 +1,100 @@
+// Shared lighting helpers for lighting.comp and radiance_cascades.comp
+// Expects: ElementData elements[], glowIntensity, glowRadius, time
+
+bool inBounds(ivec2 pos, ivec2 size) {
+    return pos.x >= 0 && pos.x < size.x && pos.y >= 0 && pos.y < size.y;
+}
+
+float hashNoise(ivec2 pos) {
+    return fract(sin(dot(vec2(pos), vec2(12.9898, 78.233))) * 43758.5453);
+}
+
+// How much light a material absorbs per pixel traversed
+// 0 = fully transparent, 1 = fully opaque
+float getOpacity(uint elem) {
+    if (elem == EMPTY || elem >= MAX_ELEMENTS) return 0.0;
+
+    int type = elements[elem].type;
+
+    // Gas: mostly transparent
+    if (type == 3) return 0.05;
+
+    // Liquid: semi-transparent
+    if (type == 2) return 0.15;
+
+    // Gemstones: semi-transparent (light passes through with color tinting)
+    if (elements[elem].gemstone == 1) return 0.2;
+
+    // Static/Granular: mostly opaque
+    return 0.85;
+}
+
+// Get the light color tint when passing through a material
+vec3 getMaterialTint(uint elem) {
+    if (elem == EMPTY || elem >= MAX_ELEMENTS) return vec3(1.0);
+
+    // Gemstones tint light with their color (caustics-like effect)
+    if (elements[elem].gemstone == 1) {
+        return elements[elem].color.rgb;
+    }
+
+    // Water tints light blue
+    if (elem == WATER) {
+        return vec3(0.7, 0.8, 1.0);
+    }
+
+    // Lava tints light orange
+    if (elem == LAVA) {
+        return vec3(1.0, 0.6, 0.2);
+    }
+
+    return vec3(1.0);
+}
+
+// Light emitted by a cell. Returns false if the cell does not emit.
+bool getEmitter(uvec4 state, ivec2 pos, out vec3 lightColor, out float radius, out float intensity) {
+    uint elem = state.r;
+    lightColor = vec3(0.0);
+    radius = glowRadius;
+    intensity = glowIntensity;
+
+    if (elem >= MAX_ELEMENTS) return false;
+
+    // Light element: strong white light
+    if (elem == LIGHT) {
+        lightColor = vec3(1.0, 0.98, 0.9);
+        radius = elements[elem].lightRadius;
+        if (radius <= 0.0) radius = 20.0;
+        intensity = elements[elem].lightIntensity;
+        if (intensity <= 0.0) intensity = 1.5;
+        return true;
+    }
+    // Fire: warm flickering light
+    if (elem == FIRE) {
+        float variation = hashNoise(pos);
+        float flicker = sin(time * 8.0 + variation * 10.0) * 0.3 + 0.7;
+        float lifeFactor = float(state.g) / 255.0;
+        lightColor = vec3(1.0, 0.5, 0.15) * flicker * lifeFactor;
+        radius = glowRadius * 1.5;
+        intensity = glowIntensity * 1.2;
+        return true;
+    }
+    // Lava: steady warm glow
+    if (elem == LAVA) {
+        float variation = hashNoise(pos);
+        float pulse = sin(time * 3.0 + variation * 6.28) * 0.15 + 0.85;
+        lightColor = vec3(1.0, 0.4, 0.1) * pulse;
+        radius = glowRadius;
+        intensity = glowIntensity * 0.8;
+        return true;
+    }
+    // Generic glow elements
+    if (elements[elem].glow == 1) {
+        lightColor = elements[elem].color.rgb;
+        radius = glowRadius;
+        intensity = glowIntensity * 0.6;
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,28 @@
+// Occupancy pyramid helpers for empty-space skipping in light ray-marches
+// Level L texel holds (max, min) opacity of a 2^L x 2^L block of cells.
+// Expects: sampler2D occupancyMap, useOccupancy, occupancyLevels
+
+// Solid cells report 0.85 opacity; a little slack for the half-float pyramid
+const float OPAQUE_OPACITY = 0.8;
+
+// (max, min) opacity of the level-L block containing cell.
+// Without a pyramid every block reads as partially occupied, giving a plain march.
+vec2 occupancyAt(ivec2 cell, int level) {
+    if (!useOccupancy) return vec2(1.0, 0.0);
+    return texelFetch(occupancyMap, cell >> level, level).rg;
+}
+
+// Samples are taken at floor(o + v * k). Returns the first k after 'current'
+// whose cell lies outside the block [lo, hi), erring towards too early.
+int firstIndexOutside(vec2 o, vec2 v, ivec2 lo, ivec2 hi, int current, int count) {
+    float kExit = float(count);
+    if (v.x > 0.0) kExit = min(kExit, ceil((float(hi.x) - o.x) / v.x - 1e-3));
+    else if (v.x < 0.0) kExit = min(kExit, floor((float(lo.x) - o.x) / v.x - 1e-3) + 1.0);
+    if (v.y > 0.0) kExit = min(kExit, ceil((float(hi.y) - o.y) / v.y - 1e-3));
+    else if (v.y < 0.0) kExit = min(kExit, floor((float(lo.y) - o.y) / v.y - 1e-3) + 1.0);
+    return max(current + 1, int(kExit));
+}
+
+bool blockContains(ivec2 lo, ivec2 hi, ivec2 cell) {
+    return all(greaterThanEqual(cell, lo)) && all(lessThan(cell, hi));
+}
@@ -0,0 +1,40 @@
+// Normal texture encoding
+// Default: RGBA16F, xyz = normal, w = specular power.
+// PACKED_NORMALS: RGBA8, rg = octahedral normal, b = specular power / MAX_SPECULAR_POWER.
+
+const float MAX_SPECULAR_POWER = 64.0;
+
+vec2 octWrap(vec2 v) {
+    return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+// Unit vector -> [-1, 1]^2
+vec2 octEncode(vec3 n) {
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    return (n.z >= 0.0) ? n.xy : octWrap(n.xy);
+}
+
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = clamp(-n.z, 0.0, 1.0);
+    n.x += (n.x >= 0.0) ? -t : t;
+    n.y += (n.y >= 0.0) ? -t : t;
+    return normalize(n);
+}
+
+vec4 encodeNormal(vec3 normal, float specPower) {
+#ifdef PACKED_NORMALS
+    return vec4(octEncode(normal) * 0.5 + 0.5, specPower / MAX_SPECULAR_POWER, 0.0);
+#else
+    return vec4(normal, specPower);
+#endif
+}
+
+// xyz = normal, w = specular power
+vec4 decodeNormal(vec4 data) {
+#ifdef PACKED_NORMALS
+    return vec4(octDecode(data.xy * 2.0 - 1.0), data.z * MAX_SPECULAR_POWER);
+#else
+    return data;
+#endif
+}
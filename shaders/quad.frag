@@ -4,7 +4,14 @@ in vec2 TexCoord;
 out vec4 FragColor;
 
 uniform sampler2D displayTex;
+uniform vec2 uvScale; // Written fraction of displayTex (dynamic resolution)
+uniform vec2 uvMax;   // Last written texel center, keeps the filter off unwritten texels
+uniform vec2 viewOrigin; // Camera rectangle in world UV
+uniform vec2 viewSize;
 
 void main() {
-    FragColor = texture(displayTex, TexCoord);
+    vec2 worldUV = viewOrigin + TexCoord * viewSize;
+    if (any(lessThan(worldUV, vec2(0.0))) || any(greaterThan(worldUV, vec2(1.0)))) discard;
+
+    FragColor = texture(displayTex, min(worldUV * uvScale, uvMax));
 }
\ No newline at end of file
@@ -0,0 +1,238 @@
+// Shared by simulation.comp and simulation_margolus.comp
+// Expects: stateIn, stateOut, ElementData elements[], worldSize, time, frameCount, trackDirty, dirty.glsl
+// and a WG_X x WG_Y workgroup. Instrumentation zeroes and flushes the shared counters from
+// the first SIM_COUNTERS invocations, so a workgroup needs at least that many.
+//
+// BATCHED (BatchWorld): stateIn/stateOut are image arrays holding one world per layer,
+// and the dispatch's z picks the layer. Activity and seeds are per layer.
+
+#ifdef BATCHED
+layout(std430, binding = 8) buffer Activity {
+    uint activityCounts[];
+};
+
+layout(std430, binding = 9) readonly buffer WorldSeeds {
+    uint worldSeeds[];
+};
+
+void markActive() {
+    uint layer = gl_GlobalInvocationID.z;
+    if (activityCounts[layer] == 0u) atomicAdd(activityCounts[layer], 1u);
+}
+
+uvec4 loadState(ivec2 pos) { return imageLoad(stateIn, ivec3(pos, gl_GlobalInvocationID.z)); }
+void storeState(ivec2 pos, uvec4 state) { imageStore(stateOut, ivec3(pos, gl_GlobalInvocationID.z), state); }
+#else
+// Nonzero once anything changed (or could change at random) during the step.
+// Read back asynchronously to detect when the world has settled.
+layout(std430, binding = 8) buffer Activity {
+    uint activityCount;
+};
+
+void markActive() {
+    // Plain read first: only the first few changes per step pay for the atomic
+    if (activityCount == 0u) atomicAdd(activityCount, 1u);
+}
+
+uvec4 loadState(ivec2 pos) { return imageLoad(stateIn, pos); }
+void storeState(ivec2 pos, uvec4 state) { imageStore(stateOut, pos, state); }
+#endif
+
+// ─── Instrumentation ───
+// SIM_INSTRUMENTATION: cells per category of event, summed over the dispatch.
+// Each workgroup counts into shared memory and adds its totals once, so the global
+// atomics cost one per counter per workgroup. With countTiles set, changed cells are
+// also added up per dirty tile for the activity heat map. Without the define these
+// compile away.
+
+const uint COUNTER_MOVED   = 0u;
+const uint COUNTER_REACTED = 1u; // Water + lava
+const uint COUNTER_BURNED  = 2u; // Ignitions
+const uint COUNTER_DECAYED = 3u; // Lifetimes run out
+const uint COUNTER_GREW    = 4u; // Grass, saplings and trees
+
+#ifdef SIM_INSTRUMENTATION
+layout(std430, binding = 11) buffer SimCounters {
+    uint simCounters[SIM_COUNTERS];
+};
+
+layout(std430, binding = 12) buffer TileChanges {
+    uint tileChanges[];
+};
+
+uniform bool countTiles;
+
+shared uint localCounters[SIM_COUNTERS];
+
+// Call from main() in uniform control flow, around the per-cell work
+void beginCounters() {
+    if (gl_LocalInvocationIndex < uint(SIM_COUNTERS)) localCounters[gl_LocalInvocationIndex] = 0u;
+    barrier();
+}
+
+void countEvent(uint counter) {
+    atomicAdd(localCounters[counter], 1u);
+}
+
+void flushCounters() {
+    barrier();
+    if (gl_LocalInvocationIndex < uint(SIM_COUNTERS)) {
+        uint count = localCounters[gl_LocalInvocationIndex];
+        if (count > 0u) atomicAdd(simCounters[gl_LocalInvocationIndex], count);
+    }
+}
+
+void countChange(ivec2 pos) {
+    if (!countTiles) return;
+    ivec2 tile = pos / DIRTY_TILE_SIZE;
+    atomicAdd(tileChanges[tile.y * dirtyTileCount(ivec2(worldSize)).x + tile.x], 1u);
+}
+#else
+void beginCounters() {}
+void countEvent(uint counter) {}
+void flushCounters() {}
+void countChange(ivec2 pos) {}
+#endif
+
+// Type constants
+const int TYPE_STATIC   = 0;
+const int TYPE_GRANULAR = 1;
+const int TYPE_LIQUID   = 2;
+const int TYPE_GAS      = 3;
+
+// ─── Helpers ───
+
+bool inBounds(ivec2 p) {
+    return (p.x >= 0 && p.x < int(worldSize.x) &&
+            p.y >= 0 && p.y < int(worldSize.y));
+}
+
+uint hashU32(uint x) {
+    x ^= x >> 16;
+    x *= 2246822519u;
+    x ^= x >> 13;
+    x *= 3266489917u;
+    x ^= x >> 16;
+    return x;
+}
+
+uint hash2u(uvec2 v) {
+    return hashU32(v.x ^ (v.y + 0x9e3779b9u + (v.x<<6) + (v.x>>2)));
+}
+
+// Hash with extra salt for independent random streams
+uint hash3u(uvec2 v, uint salt) {
+    return hashU32(v.x ^ (v.y + salt + 0x9e3779b9u + (v.x<<6) + (v.x>>2)));
+}
+
+// Per-step salt of the random streams. Batched worlds fold in their seed so layers diverge.
+uint stepSalt() {
+#ifdef BATCHED
+    return frameCount ^ hashU32(worldSeeds[gl_GlobalInvocationID.z]);
+#else
+    return frameCount;
+#endif
+}
+
+float randomTime() {
+#ifdef BATCHED
+    return time + float(worldSeeds[gl_GlobalInvocationID.z] & 0x3FFu);
+#else
+    return time;
+#endif
+}
+
+float random01(ivec2 pos) {
+    return fract(sin(dot(vec2(pos) + randomTime(), vec2(12.9898, 78.233))) * 43758.5453);
+}
+
+// Second independent hash for when we need two uncorrelated randoms at the same pos
+float random01b(ivec2 pos) {
+    return fract(sin(dot(vec2(pos) + randomTime() * 1.7, vec2(39.346, 11.135))) * 23421.6312);
+}
+
+uvec4 getState(ivec2 pos) {
+    if (!inBounds(pos)) {
+        return uvec4(255u, 0u, 0u, 0u); // solid boundary sentinel
+    }
+    return loadState(pos);
+}
+
+uint getElement(ivec2 pos) { return getState(pos).r; }
+uint getLife(ivec2 pos) { return getState(pos).g; }
+
+// ─── Type checks ───
+
+bool isStatic(uint id) {
+    return id < MAX_ELEMENTS && elements[id].type == TYPE_STATIC;
+}
+
+bool isGranular(uint id) {
+    return id < MAX_ELEMENTS && elements[id].type == TYPE_GRANULAR;
+}
+
+bool isLiquid(uint id) {
+    return id < MAX_ELEMENTS && elements[id].type == TYPE_LIQUID;
+}
+
+bool isGas(uint id) {
+    return id < MAX_ELEMENTS && elements[id].type == TYPE_GAS;
+}
+
+bool isEmpty(uint id) {
+    return id == EMPTY;
+}
+
+bool isImmobile(uint id) {
+    if (id >= MAX_ELEMENTS) return true;
+    return elements[id].type == TYPE_STATIC;
+}
+
+bool isFlammable(uint id) {
+    return id < MAX_ELEMENTS && elements[id].flammability == 1;
+}
+
+bool isGlowing(uint id) {
+    return id < MAX_ELEMENTS && elements[id].glow == 1;
+}
+
+bool hasLife(uint id) {
+    return id < MAX_ELEMENTS && elements[id].maxLife > 0;
+}
+
+// Falling elements keep their speed in B. Saplings use B as their growth step.
+bool carriesVelocity(uint id) {
+    return (isGranular(id) || isLiquid(id)) && id != SAPLING;
+}
+
+// ─── Movement Logic ───
+
+bool canDisplace(uint mover, uint target) {
+    if (target == EMPTY) return true;
+    if (mover == target) return false;
+    if (mover >= MAX_ELEMENTS || target >= MAX_ELEMENTS) return false;
+
+    float dMover = elements[mover].density;
+    float dTarget = elements[target].density;
+
+    // Fire destroys smoke (both are gases, fire is special)
+    if (mover == FIRE && target == SMOKE) return true;
+
+    // Heavier things displace lighter fluids/gases
+    if (dMover > dTarget && (isLiquid(target) || isGas(target))) return true;
+
+    // Lava/Fire burns flammable things
+    if ((mover == LAVA || mover == FIRE) && isFlammable(target)) return true;
+
+    return false;
+}
+
+// Every output goes through here so changed cells can mark their tile dirty
+void writeState(ivec2 pos, uvec4 state) {
+    storeState(pos, state);
+    if (state != loadState(pos)) {
+        markActive();
+        countChange(pos);
+        if (trackDirty) markDirty(pos, ivec2(worldSize));
+    }
+}
@@ -0,0 +1,33 @@
+// Shared tile bookkeeping for temporally amortized lighting
+// A tile is one 16x16 lighting workgroup, so tile coordinates are gl_WorkGroupID.xy.
+// Expects: temporalSlices, temporalFrame, temporalDilation, temporalReset
+
+struct TemporalTile {
+    uint signature; // Order-independent hash of the elements under the tile
+    uint changed;   // 1 if the signature differs from last frame
+};
+
+layout(std430, binding = 5) buffer TemporalTiles {
+    TemporalTile tiles[];
+};
+
+// Changed tiles and their neighbours (within the light reach) must be recomputed now
+bool tileInvalidated(ivec2 tile, ivec2 tileCount) {
+    for (int dy = -temporalDilation; dy <= temporalDilation; dy++) {
+        for (int dx = -temporalDilation; dx <= temporalDilation; dx++) {
+            ivec2 t = tile + ivec2(dx, dy);
+            if (t.x < 0 || t.y < 0 || t.x >= tileCount.x || t.y >= tileCount.y) continue;
+            if (tiles[t.y * tileCount.x + t.x].changed != 0u) return true;
+        }
+    }
+    return false;
+}
+
+// Rotating 1/temporalSlices subset, staggered per row so updates don't sweep in columns
+bool tileScheduled(ivec2 tile) {
+    return (tile.x + tile.y * 3) % temporalSlices == temporalFrame % temporalSlices;
+}
+
+bool tileActive(ivec2 tile, ivec2 tileCount) {
+    return temporalReset || tileScheduled(tile) || tileInvalidated(tile, tileCount);
+}
@@ -11,7 +11,13 @@
 */
 
 #include "app.hpp"
+#include "benchmark.hpp"
+#include "workgroup_tuner.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
 #include <iostream>
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
@@ -20,6 +26,9 @@
 
 namespace cisalpine {
 
+// Tuned workgroup shapes, keyed by deviceString()
+static const char* WORKGROUP_CACHE_PATH = "workgroups.json";
+
 void App::init(int worldW, int worldH) {
     worldWidth = worldW;
     worldHeight = worldH;
@@ -71,6 +80,7 @@ void App::init(int worldW, int worldH) {
 
     // Calculate layout
     updateLayout(windowWidth, windowHeight);
+    resetCamera();
 
     // Get shader header from registry
     std::string header = registry.getShaderHeader();
@@ -81,21 +91,26 @@ void App::init(int worldW, int worldH) {
         throw std::runtime_error("Failed to initialize world");
     }
 
+    // Shapes from an earlier tuning on this device; defaults otherwise
+    WorkgroupSizes workgroups;
+    if (loadWorkgroupCache(WORKGROUP_CACHE_PATH, deviceString(), workgroups) &&
+        !world->setWorkgroupSizes(workgroups)) {
+        std::cerr << "Ignoring cached workgroup sizes" << std::endl;
+    }
+
     // Bind registry SSBO (binding point 2 matches shader layout)
     registry.bindSSBO(2);
 
-    // Load brush shader with same header for element defines
-    if (!brushShader.loadCompute("shaders/brush.comp", header)) {
-        throw std::runtime_error("Failed to load brush shader");
-    }
+    simulationSettings = world->simulationSettings();
+    submittedSettings = simulationSettings;
 
     lastFrameTime = static_cast<float>(glfwGetTime());
 }
 
 void App::calculateWindowSize(int& windowWidth, int& windowHeight) {
-    // Viewport size = world size * pixel scale
-    int viewportWidth = worldWidth * pixelScale;
-    int viewportHeight = worldHeight * pixelScale;
+    // Viewport size = world size * pixel scale, capped for worlds larger than the screen
+    int viewportWidth = std::min(worldWidth * pixelScale, MAX_VIEWPORT_WIDTH);
+    int viewportHeight = std::min(worldHeight * pixelScale, MAX_VIEWPORT_HEIGHT);
 
     // Add UI panels
     windowWidth = viewportWidth + layout.sidePanelWidth;
@@ -110,12 +125,65 @@ void App::updateLayout(int windowWidth, int windowHeight) {
     layout.viewportHeight = windowHeight - layout.topPanelHeight - layout.bottomPanelHeight;
 }
 
+float App::fitZoom() const {
+    // Zoom at which the whole world just fits the viewport
+    return std::min(static_cast<float>(layout.viewportWidth) / static_cast<float>(worldWidth),
+                    static_cast<float>(layout.viewportHeight) / static_cast<float>(worldHeight));
+}
+
+void App::resetCamera() {
+    camera.centerX = static_cast<float>(worldWidth) * 0.5f;
+    camera.centerY = static_cast<float>(worldHeight) * 0.5f;
+    camera.zoom = fitZoom();
+}
+
+void App::clampCamera() {
+    camera.zoom = std::clamp(camera.zoom, fitZoom(), std::max(MAX_ZOOM, fitZoom()));
+
+    // Keep the view inside the world; an axis the view already spans stays centered
+    float halfWidth = static_cast<float>(layout.viewportWidth) / camera.zoom * 0.5f;
+    float halfHeight = static_cast<float>(layout.viewportHeight) / camera.zoom * 0.5f;
+    float w = static_cast<float>(worldWidth);
+    float h = static_cast<float>(worldHeight);
+    camera.centerX = (halfWidth * 2.0f >= w) ? w * 0.5f : std::clamp(camera.centerX, halfWidth, w - halfWidth);
+    camera.centerY = (halfHeight * 2.0f >= h) ? h * 0.5f : std::clamp(camera.centerY, halfHeight, h - halfHeight);
+}
+
+void App::zoomCamera(float factor, double screenX, double screenY) {
+    // Zoom about the cursor: the cell under it stays under it
+    double localX = screenX - layout.viewportX - layout.viewportWidth * 0.5;
+    double localY = layout.viewportHeight * 0.5 - (screenY - layout.viewportY);
+
+    float anchorX = camera.centerX + static_cast<float>(localX) / camera.zoom;
+    float anchorY = camera.centerY + static_cast<float>(localY) / camera.zoom;
+
+    camera.zoom *= factor;
+    clampCamera();
+
+    camera.centerX = anchorX - static_cast<float>(localX) / camera.zoom;
+    camera.centerY = anchorY - static_cast<float>(localY) / camera.zoom;
+    clampCamera();
+}
+
+WorldView App::cameraView() const {
+    WorldView view;
+    view.width = static_cast<float>(layout.viewportWidth) / camera.zoom;
+    view.height = static_cast<float>(layout.viewportHeight) / camera.zoom;
+    view.x = camera.centerX - view.width * 0.5f;
+    view.y = camera.centerY - view.height * 0.5f;
+    return view;
+}
+
+bool App::inViewport(double screenX, double screenY) const {
+    return screenX >= layout.viewportX &&
+           screenX < layout.viewportX + layout.viewportWidth &&
+           screenY >= layout.viewportY &&
+           screenY < layout.viewportY + layout.viewportHeight;
+}
+
 bool App::screenToWorld(double screenX, double screenY, int& worldX, int& worldY) {
     // Check if within viewport bounds
-    if (screenX < layout.viewportX ||
-        screenX >= layout.viewportX + layout.viewportWidth ||
-        screenY < layout.viewportY ||
-        screenY >= layout.viewportY + layout.viewportHeight) {
+    if (!inViewport(screenX, screenY)) {
         return false;
     }
 
@@ -126,9 +194,10 @@ bool App::screenToWorld(double screenX, double screenY, int& worldX, int& worldY
     // Flip Y (screen Y is top-down, world Y is bottom-up)
     localY = layout.viewportHeight - localY;
 
-    // Scale to world coordinates
-    worldX = static_cast<int>(localX / pixelScale);
-    worldY = static_cast<int>(localY / pixelScale);
+    // Through the camera to world coordinates
+    WorldView view = cameraView();
+    worldX = static_cast<int>(std::floor(view.x + localX / camera.zoom));
+    worldY = static_cast<int>(std::floor(view.y + localY / camera.zoom));
 
     return (worldX >= 0 && worldX < worldWidth && worldY >= 0 && worldY < worldHeight);
 }
@@ -139,12 +208,29 @@ void App::handleInput() {
     // Don't allow drawing if interacting with imgui
     if (io.WantCaptureMouse) {
         isDrawing = false;
+        isPanning = false;
         return;
     }
 
     double mouseX, mouseY;
     glfwGetCursorPos(window, &mouseX, &mouseY);
 
+    // Camera: wheel zooms about the cursor, middle drag pans
+    if (io.MouseWheel != 0.0f && inViewport(mouseX, mouseY)) {
+        zoomCamera(std::pow(1.25f, io.MouseWheel), mouseX, mouseY);
+        pacer.reflectInput(inputSampleTime);
+    }
+    bool middlePressed = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_MIDDLE) == GLFW_PRESS;
+    if (middlePressed && isPanning && (mouseX != panX || mouseY != panY)) {
+        camera.centerX -= static_cast<float>(mouseX - panX) / camera.zoom;
+        camera.centerY += static_cast<float>(mouseY - panY) / camera.zoom;
+        clampCamera();
+        pacer.reflectInput(inputSampleTime);
+    }
+    isPanning = middlePressed;
+    panX = mouseX;
+    panY = mouseY;
+
     bool leftPressed = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS;
     bool rightPressed = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS;
 
@@ -175,22 +261,8 @@ void App::handleInput() {
             int effectiveBrushSize = isSingleClickItem ? 0 : brushSize;
             int effectiveBrushShape = isSingleClickItem ? 0 : static_cast<int>(selectedBrush);
 
-            // Dispatch Brush Shader
-            brushShader.use();
-            brushShader.setInt("brushX", worldX);
-            brushShader.setInt("brushY", worldY);
-            brushShader.setInt("brushSize", effectiveBrushSize);
-            brushShader.setInt("brushShape", effectiveBrushShape);
-            brushShader.setUint("drawElement", static_cast<uint32_t>(selectedElementId));
-            brushShader.setBool("isEraser", erasing);
-
-            // Bind current state texture for read/write
-            glBindImageTexture(0, world->getCurrentTexture(), 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA8UI);
-
-            // Dispatch enough groups to cover brush size
-            int groups = (effectiveBrushSize * 2 + 16) / 16;
-            brushShader.dispatch(groups, groups, 1);
-            glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+            simulation.submit(PaintCommand{worldX, worldY, effectiveBrushSize, effectiveBrushShape,
+                static_cast<uint32_t>(selectedElementId), erasing, inputSampleTime});
 
             isDrawing = true;
         }
@@ -218,6 +290,37 @@ void App::renderUI() {
     ImGui::Separator();
 
     ImGui::Text("World: %dx%d", worldWidth, worldHeight);
+    ImGui::Text("Zoom: %.2fx", camera.zoom);
+
+    // MINIMAP
+    if (world->renderSettings().minimap) {
+        float mapWidth = ImGui::GetContentRegionAvail().x;
+        float mapHeight = mapWidth * static_cast<float>(world->getMinimapHeight()) /
+                          static_cast<float>(world->getMinimapWidth());
+        ImVec2 mapOrigin = ImGui::GetCursorScreenPos();
+
+        // World y is up, so flip the texture vertically
+        ImGui::Image((ImTextureID)(intptr_t)world->getMinimapTexture(),
+                     ImVec2(mapWidth, mapHeight), ImVec2(0.0f, 1.0f), ImVec2(1.0f, 0.0f));
+
+        // Click or drag to move the camera there
+        if (ImGui::IsItemHovered() && ImGui::IsMouseDown(ImGuiMouseButton_Left)) {
+            ImVec2 mouse = ImGui::GetMousePos();
+            camera.centerX = (mouse.x - mapOrigin.x) / mapWidth * static_cast<float>(worldWidth);
+            camera.centerY = (1.0f - (mouse.y - mapOrigin.y) / mapHeight) * static_cast<float>(worldHeight);
+            clampCamera();
+        }
+
+        // Camera rectangle
+        WorldView view = cameraView();
+        float toMapX = mapWidth / static_cast<float>(worldWidth);
+        float toMapY = mapHeight / static_cast<float>(worldHeight);
+        ImVec2 rectMin(mapOrigin.x + std::max(view.x, 0.0f) * toMapX,
+                       mapOrigin.y + mapHeight - std::min(view.y + view.height, static_cast<float>(worldHeight)) * toMapY);
+        ImVec2 rectMax(mapOrigin.x + std::min(view.x + view.width, static_cast<float>(worldWidth)) * toMapX,
+                       mapOrigin.y + mapHeight - std::max(view.y, 0.0f) * toMapY);
+        ImGui::GetWindowDrawList()->AddRect(rectMin, rectMax, IM_COL32(255, 255, 255, 200));
+    }
     ImGui::Text("FPS: %.1f", ImGui::GetIO().Framerate);
 
     // ELEMENTS - Data-driven from registry
@@ -308,9 +411,36 @@ void App::renderUI() {
     ImGui::Separator();
     ImGui::Text("Simulation");
 
-    SimulationSettings& simSettings = world->simulationSettings();
+    // Edited here and handed to the simulation once the UI is done
+    SimulationSettings& simSettings = simulationSettings;
 
+    const char* engines[] = { "Gather", "Margolus" };
+    int engine = static_cast<int>(simSettings.engine);
+    if (ImGui::Combo("Engine", &engine, engines, IM_ARRAYSIZE(engines))) {
+        simSettings.engine = static_cast<SimulationEngine>(engine);
+        simulation.submit(WakeCommand{});
+    }
     ImGui::SliderInt("Sim Speed", &simSettings.stepsPerFrame, 1, 10);
+    ImGui::Checkbox("Idle When Settled", &simSettings.idleWhenSettled);
+    if (simSettings.idleWhenSettled) {
+        ImGui::SameLine();
+        ImGui::TextDisabled(world->isIdle() ? "(idle)" : "(active)");
+    }
+
+    // POPULATION
+    ImGui::Checkbox("Population", &simSettings.populationStats);
+    if (simSettings.populationStats) {
+        const ElementPopulation& population = world->simulationStats().population;
+        float cells = static_cast<float>(worldWidth) * static_cast<float>(worldHeight);
+        for (size_t i = 1; i < names.size() && i < population.size(); i++) {
+            if (names[i].empty() || population[i] == 0) continue;
+
+            glm::vec4 color = registry.getColor(static_cast<int>(i));
+            ImGui::TextColored(ImVec4(color.r, color.g, color.b, 1.0f), "%s", names[i].c_str());
+            ImGui::SameLine();
+            ImGui::Text("%u (%.1f%%)", population[i], 100.0f * static_cast<float>(population[i]) / cells);
+        }
+    }
 
     // RENDER
     ImGui::Separator();
@@ -329,12 +459,122 @@ void App::renderUI() {
 
     ImGui::SliderFloat("Ambient", &settings.ambientLight, 0.0f, 1.0f);
     ImGui::SliderFloat("Specular", &settings.specularStrength, 0.0f, 2.0f);
-    ImGui::SliderInt("Bounces", &settings.lightBounces, 0, 6);
+
+    const char* lightingModels[] = { "Bounce", "Radiance Cascades" };
+    int lightingModel = static_cast<int>(settings.lightingModel);
+    if (ImGui::Combo("Lighting", &lightingModel, lightingModels, IM_ARRAYSIZE(lightingModels))) {
+        settings.lightingModel = static_cast<LightingModel>(lightingModel);
+    }
+
+    const char* lightingScales[] = { "Full", "1/2", "1/4" };
+    int lightingScale = (settings.lightingScale <= 0.25f) ? 2 : (settings.lightingScale <= 0.5f) ? 1 : 0;
+    if (ImGui::Combo("Light Res", &lightingScale, lightingScales, IM_ARRAYSIZE(lightingScales))) {
+        settings.lightingScale = 1.0f / static_cast<float>(1 << lightingScale);
+    }
+
+    ImGui::Checkbox("Skip Empty Space", &settings.occupancySkipping);
+    ImGui::Checkbox("Fused Composite", &settings.fusedComposite);
+    ImGui::Checkbox("Dirty Tiles Only", &settings.dirtyTracking);
+    ImGui::Checkbox("Animated Effects", &settings.animatedEffects);
+    ImGui::Checkbox("Overview LOD", &settings.overviewRendering);
+    ImGui::Checkbox("Minimap", &settings.minimap);
+
+    // Debug: the simulation accumulates per-tile activity only while this is shown
+    const char* overlays[] = { "Off", "Heat Map", "Changed Tiles" };
+    int overlay = static_cast<int>(settings.activityOverlay);
+    if (ImGui::Combo("Activity", &overlay, overlays, IM_ARRAYSIZE(overlays))) {
+        settings.activityOverlay = static_cast<ActivityOverlay>(overlay);
+    }
+    simSettings.tileActivity = settings.activityOverlay != ActivityOverlay::Off;
+
+    if (settings.lightingModel == LightingModel::Bounce) {
+        ImGui::SliderInt("Bounces", &settings.lightBounces, 0, 6);
+        ImGui::Checkbox("Shadow Maps", &settings.shadowMaps);
+        if (settings.shadowMaps) {
+            ImGui::SliderInt("Shadowed Lights", &settings.shadowMapLights, 1, 16);
+        }
+        ImGui::Checkbox("Temporal Lighting", &settings.temporalLighting);
+        if (settings.temporalLighting) {
+            ImGui::SliderInt("Update Slices", &settings.temporalSlices, 1, 16);
+            ImGui::SliderFloat("History Blend", &settings.temporalBlend, 0.05f, 1.0f);
+        }
+    } else {
+        ImGui::SliderInt("Cascades", &settings.cascadeCount, 0, 6, settings.cascadeCount == 0 ? "Auto" : "%d");
+        ImGui::SliderFloat("Interval", &settings.cascadeInterval, 0.5f, 8.0f);
+        ImGui::SliderFloat("GI Emission", &settings.cascadeEmission, 0.5f, 20.0f);
+    }
+
+    // FORMATS
+    ImGui::Separator();
+    ImGui::Text("Formats");
+    ImGui::Checkbox("Compact Lightmaps", &settings.compactLightmaps);
+    ImGui::Checkbox("Packed Normals", &settings.packedNormals);
+    ImGui::Checkbox("10-bit Display", &settings.compactDisplay);
+
+    constexpr float MB = 1024.0f * 1024.0f;
+    MemoryUsage memory = world->memoryUsage();
+    MemoryUsage baseline = world->uncompactedMemoryUsage();
+    ImGui::Text("GPU Memory: %.1f MB", static_cast<float>(memory.total()) / MB);
+    ImGui::BulletText("State: %.1f MB", static_cast<float>(memory.state) / MB);
+    ImGui::BulletText("Color/Normals: %.1f MB", static_cast<float>(memory.renderTargets) / MB);
+    ImGui::BulletText("Lightmaps: %.1f MB", static_cast<float>(memory.lightmaps) / MB);
+    ImGui::BulletText("Display: %.1f MB", static_cast<float>(memory.display) / MB);
+    ImGui::BulletText("Lighting Data: %.1f MB", static_cast<float>(memory.lighting) / MB);
+    ImGui::BulletText("Transients: %.1f MB", static_cast<float>(memory.transient) / MB);
+    ImGui::Text("Saved by formats: %.1f MB", static_cast<float>(baseline.total() - memory.total()) / MB);
+
+    // PERFORMANCE
+    ImGui::Separator();
+    ImGui::Text("Performance");
+
+    ImGui::Checkbox("Step Governor", &simSettings.stepGovernor);
+    if (simSettings.stepGovernor) {
+        ImGui::SliderFloat("Frame Budget (ms)", &simSettings.frameBudgetMs, 2.0f, 33.0f, "%.1f");
+        ImGui::Checkbox("Degrade Lighting", &simSettings.degradeLighting);
+    }
+    ImGui::Checkbox("Dynamic Resolution", &settings.dynamicResolution);
+    if (settings.dynamicResolution) {
+        ImGui::SliderFloat("Target Frame (ms)", &settings.targetFrameMs, 4.0f, 33.0f, "%.1f");
+        ImGui::SliderFloat("Min Scale", &settings.minRenderScale, 0.25f, 1.0f, "%.2f");
+    }
+
+    const SimulationStats& stats = world->simulationStats();
+    ImGui::BulletText("Step: %.3f ms", stats.stepMs);
+    if (simSettings.engine == SimulationEngine::Margolus) {
+        ImGui::BulletText("Reactions: %.3f ms", stats.reactionMs);
+    }
+    ImGui::Checkbox("Instrument Steps", &simSettings.instrumentation);
+    if (simSettings.instrumentation) {
+        for (int i = 0; i < SIM_COUNTERS; i++) {
+            ImGui::BulletText("Cells %s: %.0f / step", SIM_COUNTER_NAMES[i], stats.eventsPerStep[i]);
+        }
+    }
+    ImGui::BulletText("Render: %.2f ms", stats.renderMs);
+    const FrameGraph::Stats& graph = world->frameGraphStats();
+    ImGui::BulletText("Passes: %d (%d barriers)", graph.passes, graph.barriers);
+
+    // 1 = lowest input latency, 3 = most CPU/GPU overlap
+    ImGui::SliderInt("Frames in Flight", &framesInFlight, 1, FramePacer::MAX_FRAMES_IN_FLIGHT);
+    ImGui::BulletText("Input Latency: %.1f ms", pacer.stats().latencyMs);
+    ImGui::BulletText("CPU Wait: %.2f ms", pacer.stats().waitMs);
+    if (stats.stepLimit > 0) {
+        ImGui::BulletText("Steps: %d / %d", stats.stepsLastFrame, stats.stepLimit);
+    } else {
+        ImGui::BulletText("Steps: %d", stats.stepsLastFrame);
+    }
+    ImGui::BulletText("Sim Debt: %.2f s", stats.debtSeconds);
+    ImGui::BulletText("Render Scale: %.0f%%", stats.renderScale * 100.0f);
+    if (stats.lightingDegrade > 0) {
+        ImGui::BulletText("Lighting Degrade: %d", stats.lightingDegrade);
+    }
 
     // ACTIONS
     ImGui::Separator();
     if (ImGui::Button("Clear World", ImVec2(-1, 0))) {
-        world->clear();
+        simulation.submit(ClearCommand{});
+    }
+    if (ImGui::Button("Reset View", ImVec2(-1, 0))) {
+        resetCamera();
     }
 
     // CONTROLS
@@ -342,6 +582,8 @@ void App::renderUI() {
     ImGui::Text("Controls");
     ImGui::BulletText("LMB: Draw");
     ImGui::BulletText("RMB: Erase");
+    ImGui::BulletText("Wheel: Zoom");
+    ImGui::BulletText("MMB: Pan");
 
     ImGui::Separator();
     const char* selectedName = (selectedElementId == 0) ? "Eraser"
@@ -356,8 +598,23 @@ void App::renderUI() {
 }
 
 void App::run() {
+    // Falls back to simulating inline below if the thread cannot get a context
+    simulation.start(window, *world, registry);
+
     while (!glfwWindowShouldClose(window)) {
-        glfwPollEvents();
+        // Wait for the GPU to free this frame's slot before sampling input, so input
+        // never sits behind more than framesInFlight queued frames
+        pacer.setFramesInFlight(framesInFlight);
+        world->setFrameSlot(pacer.beginFrame());
+
+        // A settled world has nothing to animate: sleep until input arrives
+        // (the timeout keeps the UI responsive to non-input changes)
+        if (world->isIdle()) {
+            glfwWaitEventsTimeout(0.25);
+        } else {
+            glfwPollEvents();
+        }
+        inputSampleTime = glfwGetTime();
 
         // Calculate delta time
         float currentTime = static_cast<float>(glfwGetTime());
@@ -368,8 +625,10 @@ void App::run() {
 
         handleInput();
 
-        // Update simulation
-        world->update(dt);
+        // Update simulation (the simulation thread steps on its own clock)
+        if (!simulation.running()) {
+            world->update(dt);
+        }
 
         // Start ImGui frame
         ImGui_ImplOpenGL3_NewFrame();
@@ -377,6 +636,9 @@ void App::run() {
         ImGui::NewFrame();
 
         renderUI();
+        if (simulationSettings != submittedSettings && simulation.submit(SettingsCommand{simulationSettings})) {
+            submittedSettings = simulationSettings;
+        }
 
         // Render
         ImGui::Render();
@@ -389,16 +651,125 @@ void App::run() {
 
         // Render world to viewport area
         world->render(layout.viewportX, layout.viewportY,
-                      layout.viewportWidth, layout.viewportHeight);
+                      layout.viewportWidth, layout.viewportHeight, cameraView());
+
+        // Brush strokes show up once the state that applied them is drawn
+        double reflected = world->reflectedInputTime();
+        if (reflected > lastReflectedInput) {
+            pacer.reflectInput(reflected);
+            lastReflectedInput = reflected;
+        }
 
         // Render ImGui on top
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
         glfwSwapBuffers(window);
+        pacer.endFrame();
+    }
+
+    simulation.stop();
+}
+
+void App::tuneWorkgroups() {
+    BenchmarkScenario scenario = benchmarkScenarios(worldWidth, worldHeight).back(); // mixed
+    WorkgroupTuning tuning = cisalpine::tuneWorkgroups(*world, [&](World& target) {
+        scenario.setup(target, registry);
+    });
+
+    for (int k = 0; k < KERNEL_COUNT; k++) {
+        std::cout << KERNEL_NAMES[k] << ":";
+        for (size_t c = 0; c < WORKGROUP_CANDIDATES.size(); c++) {
+            std::cout << " " << WORKGROUP_CANDIDATES[c].x << "x" << WORKGROUP_CANDIDATES[c].y << " ";
+            if (tuning.candidateMs[k][c] < 0.0) std::cout << "-";
+            else std::cout << tuning.candidateMs[k][c] << " ms";
+        }
+        std::cout << " -> " << tuning.sizes[k].x << "x" << tuning.sizes[k].y << std::endl;
+    }
+    saveWorkgroupCache(WORKGROUP_CACHE_PATH, deviceString(), tuning.sizes);
+
+    simulationSettings = world->simulationSettings();
+    submittedSettings = simulationSettings;
+}
+
+void App::runBenchmark(const std::string& outputPath, bool instrument) {
+    constexpr int MAX_STEPS = 6000;
+    const SimulationEngine engines[] = { SimulationEngine::Gather, SimulationEngine::Margolus };
+
+    // Benchmark the shapes this device runs best
+    tuneWorkgroups();
+    world->simulationSettings().instrumentation = instrument;
+
+    // Present every frame so a long run is visibly alive; rendering is outside the timed steps
+    auto present = [this]() {
+        glfwPollEvents();
+        int displayW, displayH;
+        glfwGetFramebufferSize(window, &displayW, &displayH);
+        glViewport(0, 0, displayW, displayH);
+        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        world->render(layout.viewportX, layout.viewportY,
+                      layout.viewportWidth, layout.viewportHeight, cameraView());
+        glfwSwapBuffers(window);
+    };
+
+    nlohmann::json results = nlohmann::json::array();
+    for (const BenchmarkScenario& scenario : benchmarkScenarios(worldWidth, worldHeight)) {
+        for (SimulationEngine engine : engines) {
+            BenchmarkResult result = cisalpine::runBenchmark(*world, registry, scenario, engine, MAX_STEPS, present);
+            std::cout << result.scenario << " [" << result.engine << "]: "
+                      << result.steps << " steps" << (result.settled ? "" : " (unsettled)") << ", "
+                      << result.gpuMsPerStep << " ms/step GPU, "
+                      << result.wallMs << " ms wall" << std::endl;
+            if (engine == SimulationEngine::Margolus) {
+                std::cout << "    of which reactions " << result.reactionGpuMsPerStep << " ms/step GPU" << std::endl;
+            }
+            if (result.instrumented) {
+                std::cout << "   ";
+                for (int i = 0; i < SIM_COUNTERS; i++) {
+                    std::cout << " " << SIM_COUNTER_NAMES[i] << " " << result.eventsPerStep[i];
+                }
+                std::cout << " per step" << std::endl;
+            }
+            results.push_back(toJson(result));
+        }
+    }
+
+    // Batched small worlds: throughput should grow with the batch size
+    constexpr int BATCH_WORLD_SIZE = 256;
+    constexpr int BATCH_STEPS = 300;
+    nlohmann::json batches = nlohmann::json::array();
+    for (int worlds : {1, 16, 64, 256}) {
+        BatchBenchmarkResult result = runBatchBenchmark(registry, BATCH_WORLD_SIZE, worlds, BATCH_STEPS,
+                                                        world->workgroupSizes()[static_cast<int>(Kernel::Simulation)]);
+        if (result.steps == 0) {
+            std::cout << "batch x" << worlds << ": skipped" << std::endl;
+            continue;
+        }
+        std::cout << "batch x" << worlds << ": " << result.worldStepsPerSecond << " world-steps/s, "
+                  << result.wallMs << " ms wall" << std::endl;
+        batches.push_back(toJson(result));
+    }
+
+    nlohmann::json report = {
+        {"worldWidth", worldWidth},
+        {"worldHeight", worldHeight},
+        {"device", deviceString()},
+        {"workgroups", toJson(world->workgroupSizes())},
+        {"results", results},
+        {"batch", batches},
+    };
+
+    std::ofstream file(outputPath);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open benchmark output: " + outputPath);
     }
+    file << report.dump(2) << std::endl;
+    std::cout << "Benchmark written to " << outputPath << std::endl;
 }
 
 void App::shutdown() {
+    simulation.stop();
+    pacer.release();
     world.reset();
 
     ImGui_ImplOpenGL3_Shutdown();
@@ -0,0 +1,156 @@
+/*
+* File: batch_world.cpp
+* Project: Cisalpine Engine
+* Author: Collin Longoria
+* Created on: 10/16/2026
+*
+* Copyright (c) 2025 Collin Longoria
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+
+#include "batch_world.hpp"
+
+#include "world.hpp"
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+
+namespace cisalpine {
+
+// dirty.glsl needs a tile size; batched worlds never track dirty tiles
+constexpr int BATCH_DIRTY_TILE_SIZE = 16;
+
+BatchWorld::BatchWorld(int width, int height, int count)
+    : worldWidth(width), worldHeight(height), worldCount(count) {}
+
+BatchWorld::~BatchWorld() {
+    if (stateTextures[0]) glDeleteTextures(2, stateTextures);
+    if (seedBuffer) glDeleteBuffers(1, &seedBuffer);
+    if (activityBuffer) glDeleteBuffers(1, &activityBuffer);
+}
+
+bool BatchWorld::init(const std::string& elementHeader, WorkgroupSize workgroup) {
+    GLint maxLayers = 0;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    if (worldCount < 1 || worldCount > maxLayers) {
+        std::cerr << "Batch of " << worldCount << " worlds exceeds " << maxLayers << " array layers" << std::endl;
+        return false;
+    }
+
+    std::string header = elementHeader;
+    header += "#define DIRTY_TILE_SIZE " + std::to_string(BATCH_DIRTY_TILE_SIZE) + "\n";
+    header += "#define BATCHED\n";
+    header += workgroupDefines(workgroup);
+    stepGroup = workgroup;
+    if (!simulationShader.loadCompute("shaders/simulation.comp", header)) {
+        std::cerr << "Failed to load batched simulation shader" << std::endl;
+        return false;
+    }
+
+    // State arrays (RGBA8UI), cleared to empty
+    glCreateTextures(GL_TEXTURE_2D_ARRAY, 2, stateTextures);
+    for (GLuint texture : stateTextures) {
+        glTextureStorage3D(texture, 1, GL_RGBA8UI, worldWidth, worldHeight, worldCount);
+        glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glClearTexImage(texture, 0, GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, nullptr);
+    }
+
+    glCreateBuffers(1, &seedBuffer);
+    glNamedBufferStorage(seedBuffer, worldCount * sizeof(uint32_t), nullptr, GL_DYNAMIC_STORAGE_BIT);
+    std::vector<uint32_t> seeds(worldCount);
+    std::iota(seeds.begin(), seeds.end(), 0u);
+    setSeeds(seeds);
+
+    glCreateBuffers(1, &activityBuffer);
+    glNamedBufferStorage(activityBuffer, worldCount * sizeof(uint32_t), nullptr, GL_DYNAMIC_STORAGE_BIT);
+    glClearNamedBufferData(activityBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+    return true;
+}
+
+void BatchWorld::step(int steps) {
+    glClearNamedBufferData(activityBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+    simulationShader.use();
+    simulationShader.setVec2("worldSize", static_cast<float>(worldWidth), static_cast<float>(worldHeight));
+    simulationShader.setBool("trackDirty", false);
+
+    // SSBO 8: activity per world, SSBO 9: seed per world
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 8, activityBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 9, seedBuffer);
+
+    GLuint groupsX = workgroupCount(worldWidth, stepGroup.x);
+    GLuint groupsY = workgroupCount(worldHeight, stepGroup.y);
+
+    for (int i = 0; i < steps; i++) {
+        // binding 0: stateIn, binding 1: stateOut, every layer at once
+        glBindImageTexture(0, stateTextures[currentBuffer], 0, GL_TRUE, 0, GL_READ_ONLY, GL_RGBA8UI);
+        glBindImageTexture(1, stateTextures[1 - currentBuffer], 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_RGBA8UI);
+
+        simulationShader.setFloat("time", simulationTime);
+        simulationShader.setUint("frameCount", frameCount);
+
+        glDispatchCompute(groupsX, groupsY, static_cast<GLuint>(worldCount));
+        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+
+        currentBuffer = 1 - currentBuffer;
+        frameCount++;
+        simulationTime += World::FIXED_TIMESTEP;
+    }
+}
+
+void BatchWorld::setSeed(int world, uint32_t seed) {
+    if (world < 0 || world >= worldCount) return;
+    glNamedBufferSubData(seedBuffer, world * sizeof(uint32_t), sizeof(uint32_t), &seed);
+}
+
+void BatchWorld::setSeeds(const std::vector<uint32_t>& seeds) {
+    GLsizeiptr count = std::min(static_cast<int>(seeds.size()), worldCount);
+    glNamedBufferSubData(seedBuffer, 0, count * sizeof(uint32_t), seeds.data());
+}
+
+void BatchWorld::clear() {
+    glClearTexImage(stateTextures[currentBuffer], 0, GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, nullptr);
+}
+
+void BatchWorld::fill(int world, int x0, int y0, int x1, int y1, uint32_t element) {
+    x0 = std::clamp(x0, 0, worldWidth);
+    y0 = std::clamp(y0, 0, worldHeight);
+    x1 = std::clamp(x1, 0, worldWidth);
+    y1 = std::clamp(y1, 0, worldHeight);
+    if (world < 0 || world >= worldCount || x1 <= x0 || y1 <= y0) return;
+
+    uint8_t cell[4] = {static_cast<uint8_t>(element), 0, 0, 0};
+    glClearTexSubImage(stateTextures[currentBuffer], 0, x0, y0, world, x1 - x0, y1 - y0, 1,
+        GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, cell);
+}
+
+void BatchWorld::load(int world, const std::vector<uint8_t>& cells) {
+    if (world < 0 || world >= worldCount) return;
+    if (cells.size() < static_cast<size_t>(worldWidth) * worldHeight * 4) return;
+
+    // Steps write the state with imageStore; let them land before the upload replaces it
+    glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+    glTextureSubImage3D(stateTextures[currentBuffer], 0, 0, 0, world, worldWidth, worldHeight, 1,
+        GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, cells.data());
+}
+
+void BatchWorld::observe(int world, std::vector<uint8_t>& cells) const {
+    if (world < 0 || world >= worldCount) return;
+
+    cells.resize(static_cast<size_t>(worldWidth) * worldHeight * 4);
+    glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT); // Steps write the state with imageStore
+    glGetTextureSubImage(stateTextures[currentBuffer], 0, 0, 0, world, worldWidth, worldHeight, 1,
+        GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, static_cast<GLsizei>(cells.size()), cells.data());
+}
+
+void BatchWorld::activity(std::vector<uint32_t>& changed) const {
+    changed.resize(worldCount);
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT); // Steps bump the counts with shader atomics
+    glGetNamedBufferSubData(activityBuffer, 0, worldCount * sizeof(uint32_t), changed.data());
+}
+
+}
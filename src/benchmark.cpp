@@ -0,0 +1,200 @@
+/*
+* File: benchmark.cpp
+* Project: Cisalpine Engine
+* Author: Collin Longoria
+* Created on: 10/16/2026
+*
+* Copyright (c) 2025 Collin Longoria
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+
+#include "benchmark.hpp"
+
+#include "batch_world.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace cisalpine {
+
+namespace {
+
+// Square brush, matching BrushShape::Square
+constexpr int SQUARE = 1;
+
+void fill(World& world, const Registry& registry, const std::string& element, int x, int y, int radius) {
+    int id = registry.getId(element);
+    if (id < 0) return;
+    world.paint(x, y, radius, SQUARE, static_cast<uint32_t>(id), false);
+}
+
+}
+
+std::vector<BenchmarkScenario> benchmarkScenarios(int worldWidth, int worldHeight) {
+    int cx = worldWidth / 2;
+    int r = std::max(std::min(worldWidth, worldHeight) / 8, 2);
+    int top = worldHeight - r - 1;
+
+    return {
+        {"sand_drop", [=](World& world, const Registry& registry) {
+            fill(world, registry, "Sand", cx, top, r);
+        }},
+        {"water_fill", [=](World& world, const Registry& registry) {
+            fill(world, registry, "Water", r + 1, top, r);
+        }},
+        {"mixed", [=](World& world, const Registry& registry) {
+            fill(world, registry, "Stone", cx, worldHeight / 2, r / 2);
+            fill(world, registry, "Sand", cx, top, r);
+            fill(world, registry, "Water", cx - 2 * r - 1, top, r);
+            fill(world, registry, "Water", cx + 2 * r + 1, top, r);
+        }},
+    };
+}
+
+BenchmarkResult runBenchmark(World& world, const Registry& registry, const BenchmarkScenario& scenario,
+                             SimulationEngine engine, int maxSteps,
+                             const std::function<void()>& frameCallback) {
+    BenchmarkResult result;
+    result.scenario = scenario.name;
+    result.engine = engineName(engine);
+
+    // One step per update, uncapped, so both engines advance in lockstep with the step count
+    SimulationSettings saved = world.simulationSettings();
+    SimulationSettings& settings = world.simulationSettings();
+    settings.engine = engine;
+    settings.stepsPerFrame = 1;
+    settings.stepGovernor = false;
+    settings.idleWhenSettled = true;
+
+    world.clear();
+    scenario.setup(world, registry);
+    glFinish();
+
+    double gpuMsBefore = world.simulationStats().timedStepMs;
+    long long gpuStepsBefore = world.simulationStats().timedSteps;
+    double reactionMsBefore = world.simulationStats().timedReactionMs;
+    long long reactionPassesBefore = world.simulationStats().timedReactionPasses;
+    std::array<double, SIM_COUNTERS> eventsBefore = world.simulationStats().countedEvents;
+    long long countedStepsBefore = world.simulationStats().countedSteps;
+
+    auto start = std::chrono::steady_clock::now();
+    while (result.steps < maxSteps) {
+        world.update(World::FIXED_TIMESTEP);
+        glFinish();
+        result.steps += world.simulationStats().stepsLastFrame;
+        if (world.isIdle()) {
+            result.settled = true;
+            break;
+        }
+        if (frameCallback) frameCallback();
+    }
+    auto end = std::chrono::steady_clock::now();
+    result.wallMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+    // Collect the timings still in flight; an idle update only polls
+    world.update(0.0f);
+
+    long long gpuSteps = world.simulationStats().timedSteps - gpuStepsBefore;
+    if (gpuSteps > 0) {
+        result.gpuMsPerStep = (world.simulationStats().timedStepMs - gpuMsBefore) / static_cast<double>(gpuSteps);
+    }
+    long long reactionPasses = world.simulationStats().timedReactionPasses - reactionPassesBefore;
+    if (reactionPasses > 0) {
+        result.reactionGpuMsPerStep = (world.simulationStats().timedReactionMs - reactionMsBefore) / static_cast<double>(reactionPasses);
+    }
+
+    result.instrumented = settings.instrumentation;
+    long long countedSteps = world.simulationStats().countedSteps - countedStepsBefore;
+    if (countedSteps > 0) {
+        for (int i = 0; i < SIM_COUNTERS; i++) {
+            result.eventsPerStep[i] = (world.simulationStats().countedEvents[i] - eventsBefore[i]) / static_cast<double>(countedSteps);
+        }
+    }
+
+    settings = saved;
+    return result;
+}
+
+BatchBenchmarkResult runBatchBenchmark(const Registry& registry, int worldSize, int worlds, int steps,
+                                       WorkgroupSize workgroup) {
+    BatchBenchmarkResult result;
+    result.worlds = worlds;
+    result.worldSize = worldSize;
+
+    BatchWorld batch(worldSize, worldSize, worlds);
+    if (!batch.init(registry.getShaderHeader(), workgroup)) return result;
+
+    // The mixed scene in every world; seeds keep the worlds from evolving in lockstep
+    int cx = worldSize / 2;
+    int r = std::max(worldSize / 8, 2);
+    int top = worldSize - r - 1;
+    auto fill = [&](int world, const std::string& element, int x, int y, int radius) {
+        int id = registry.getId(element);
+        if (id < 0) return;
+        batch.fill(world, x - radius, y - radius, x + radius + 1, y + radius + 1, static_cast<uint32_t>(id));
+    };
+    for (int world = 0; world < worlds; world++) {
+        fill(world, "Stone", cx, worldSize / 2, r / 2);
+        fill(world, "Sand", cx, top, r);
+        fill(world, "Water", cx - 2 * r - 1, top, r);
+        fill(world, "Water", cx + 2 * r + 1, top, r);
+    }
+    glFinish();
+
+    auto start = std::chrono::steady_clock::now();
+    batch.step(steps);
+    glFinish();
+    auto end = std::chrono::steady_clock::now();
+
+    result.steps = steps;
+    result.wallMs = std::chrono::duration<double, std::milli>(end - start).count();
+    if (result.wallMs > 0.0) {
+        result.worldStepsPerSecond = static_cast<double>(worlds) * steps * 1000.0 / result.wallMs;
+    }
+    return result;
+}
+
+const char* engineName(SimulationEngine engine) {
+    switch (engine) {
+        case SimulationEngine::Gather:   return "gather";
+        case SimulationEngine::Margolus: return "margolus";
+    }
+    return "unknown";
+}
+
+nlohmann::json toJson(const BenchmarkResult& result) {
+    nlohmann::json json = {
+        {"scenario", result.scenario},
+        {"engine", result.engine},
+        {"steps", result.steps},
+        {"settled", result.settled},
+        {"gpuMsPerStep", result.gpuMsPerStep},
+        {"wallMs", result.wallMs},
+    };
+    if (result.engine == engineName(SimulationEngine::Margolus)) {
+        // Split so the block pass alone can be set against the single-pass gather engine
+        json["reactionGpuMsPerStep"] = result.reactionGpuMsPerStep;
+        json["blockGpuMsPerStep"] = result.gpuMsPerStep - result.reactionGpuMsPerStep;
+    }
+    if (result.instrumented) {
+        nlohmann::json events = nlohmann::json::object();
+        for (int i = 0; i < SIM_COUNTERS; i++) {
+            events[SIM_COUNTER_NAMES[i]] = result.eventsPerStep[i];
+        }
+        json["eventsPerStep"] = events;
+    }
+    return json;
+}
+
+nlohmann::json toJson(const BatchBenchmarkResult& result) {
+    return {
+        {"worlds", result.worlds},
+        {"worldSize", result.worldSize},
+        {"steps", result.steps},
+        {"wallMs", result.wallMs},
+        {"worldStepsPerSecond", result.worldStepsPerSecond},
+    };
+}
+
+}
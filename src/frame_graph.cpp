@@ -0,0 +1,292 @@
+/*
+* File: frame_graph.cpp
+* Project: Cisalpine Engine
+* Author: Collin Longoria
+* Created on: 10/16/2026
+*
+* Copyright (c) 2025 Collin Longoria
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+
+#include "frame_graph.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+namespace cisalpine {
+
+FrameGraph::~FrameGraph() {
+    for (PooledTexture& entry : pool) {
+        if (entry.texture) glDeleteTextures(1, &entry.texture);
+    }
+}
+
+// ─── Recording ───
+
+FrameGraph::PassBuilder& FrameGraph::PassBuilder::read(GLuint unit, FrameResource texture, GLenum format, int level) {
+    return graph.access(*this, {texture, Usage::Image, unit, format, level, true, false});
+}
+
+FrameGraph::PassBuilder& FrameGraph::PassBuilder::write(GLuint unit, FrameResource texture, GLenum format, int level) {
+    return graph.access(*this, {texture, Usage::Image, unit, format, level, false, true});
+}
+
+FrameGraph::PassBuilder& FrameGraph::PassBuilder::readWrite(GLuint unit, FrameResource texture, GLenum format, int level) {
+    return graph.access(*this, {texture, Usage::Image, unit, format, level, true, true});
+}
+
+FrameGraph::PassBuilder& FrameGraph::PassBuilder::sample(GLuint unit, FrameResource texture) {
+    return graph.access(*this, {texture, Usage::Sampler, unit, GL_NONE, 0, true, false});
+}
+
+FrameGraph::PassBuilder& FrameGraph::PassBuilder::storage(GLuint binding, FrameResource buffer, bool writes) {
+    return graph.access(*this, {buffer, Usage::Storage, binding, GL_NONE, 0, true, writes});
+}
+
+void FrameGraph::PassBuilder::execute(std::function<void()> fn) {
+    graph.passes[pass].fn = std::move(fn);
+}
+
+FrameGraph::PassBuilder& FrameGraph::access(PassBuilder& builder, const Access& entry) {
+    // An invalid handle would leave the unit bound to whatever the last pass used
+    if (entry.resource < 0 || entry.resource >= static_cast<int>(resources.size())) {
+        std::cerr << "FrameGraph: pass '" << passes[builder.pass].name << "' declared invalid resource "
+                  << entry.resource << " at unit " << entry.unit << std::endl;
+        return builder;
+    }
+
+    passes[builder.pass].accesses.push_back(entry);
+
+    Resource& resource = resources[entry.resource];
+    if (resource.firstPass < 0) resource.firstPass = builder.pass;
+    resource.lastPass = builder.pass;
+    return builder;
+}
+
+void FrameGraph::beginFrame(int slot) {
+    frameSlot = slot;
+    resources.clear();
+    passes.clear();
+    hazards.clear();
+    frameStats = Stats();
+}
+
+FrameResource FrameGraph::importTexture(const char* name, GLuint texture) {
+    Resource resource;
+    resource.name = name;
+    resource.object = texture;
+    resources.push_back(resource);
+    return static_cast<FrameResource>(resources.size() - 1);
+}
+
+FrameResource FrameGraph::importBuffer(const char* name, GLuint buffer) {
+    Resource resource;
+    resource.name = name;
+    resource.buffer = true;
+    resource.object = buffer;
+    resources.push_back(resource);
+    return static_cast<FrameResource>(resources.size() - 1);
+}
+
+FrameResource FrameGraph::createTexture(const char* name, const TextureDesc& desc) {
+    Resource resource;
+    resource.name = name;
+    resource.transient = true;
+    resource.desc = desc;
+    resources.push_back(resource);
+    return static_cast<FrameResource>(resources.size() - 1);
+}
+
+FrameGraph::PassBuilder FrameGraph::addPass(const char* name) {
+    Pass pass;
+    pass.name = name;
+    passes.push_back(std::move(pass));
+    return PassBuilder(*this, static_cast<int>(passes.size() - 1));
+}
+
+GLuint FrameGraph::texture(FrameResource resource) const {
+    if (resource < 0 || resource >= static_cast<int>(resources.size())) return 0;
+    return resources[resource].object;
+}
+
+// ─── Execution ───
+
+void FrameGraph::execute() {
+    for (int i = 0; i < static_cast<int>(passes.size()); i++) {
+        const Pass& pass = passes[i];
+        allocateTransients(i);
+        barrierFor(pass);
+        bind(pass);
+        if (pass.fn) pass.fn();
+        releaseTransients(i);
+    }
+    frameStats.passes = static_cast<int>(passes.size());
+
+    // Whatever follows the frame (the blit, the UI, next frame's simulation) reads
+    // outputs outside the graph, so settle every write still in flight
+    GLbitfield bits = 0;
+    for (const Hazard& hazard : hazards) {
+        if (hazard.written) bits |= hazard.writeBits & ~hazard.visible;
+    }
+    if (bits) {
+        glMemoryBarrier(bits);
+        frameStats.barriers++;
+    }
+
+    trimPool();
+}
+
+void FrameGraph::allocateTransients(int pass) {
+    for (Resource& resource : resources) {
+        if (!resource.transient || resource.firstPass != pass) continue;
+
+        // Any free texture of this slot with the same description, else a new one
+        auto free = std::find_if(pool.begin(), pool.end(), [&](const PooledTexture& entry) {
+            return !entry.inUse && entry.slot == frameSlot && entry.desc == resource.desc;
+        });
+        if (free == pool.end()) {
+            PooledTexture entry;
+            entry.desc = resource.desc;
+            entry.slot = frameSlot;
+            glCreateTextures(GL_TEXTURE_2D, 1, &entry.texture);
+            glTextureStorage2D(entry.texture, 1, entry.desc.format, entry.desc.width, entry.desc.height);
+            glTextureParameteri(entry.texture, GL_TEXTURE_MIN_FILTER, entry.desc.filter);
+            glTextureParameteri(entry.texture, GL_TEXTURE_MAG_FILTER, entry.desc.filter);
+            glTextureParameteri(entry.texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTextureParameteri(entry.texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            pool.push_back(entry);
+            free = pool.end() - 1;
+        }
+
+        free->inUse = true;
+        free->idleFrames = -1; // Marks the entry as used this frame
+        resource.object = free->texture;
+        frameStats.transients++;
+    }
+}
+
+void FrameGraph::releaseTransients(int pass) {
+    for (Resource& resource : resources) {
+        if (!resource.transient || resource.lastPass != pass) continue;
+
+        for (PooledTexture& entry : pool) {
+            if (entry.texture == resource.object) entry.inUse = false;
+        }
+        resource.object = 0;
+    }
+}
+
+void FrameGraph::trimPool() {
+    // A slot comes round every few frames, well inside POOL_KEEP_FRAMES
+    for (PooledTexture& entry : pool) {
+        entry.inUse = false;
+        entry.idleFrames++;
+        if (entry.idleFrames >= POOL_KEEP_FRAMES) {
+            glDeleteTextures(1, &entry.texture);
+            entry.texture = 0;
+        }
+    }
+    pool.erase(std::remove_if(pool.begin(), pool.end(),
+        [](const PooledTexture& entry) { return entry.texture == 0; }), pool.end());
+
+    frameStats.pooledTextures = static_cast<int>(pool.size());
+    frameStats.pooledBytes = 0;
+    for (const PooledTexture& entry : pool) {
+        frameStats.pooledBytes += static_cast<size_t>(entry.desc.width) * entry.desc.height * bytesPerTexel(entry.desc.format);
+    }
+}
+
+FrameGraph::Hazard& FrameGraph::hazardFor(GLuint object, bool buffer, int level) {
+    for (Hazard& hazard : hazards) {
+        if (hazard.object == object && hazard.buffer == buffer && hazard.level == level) return hazard;
+    }
+    Hazard hazard;
+    hazard.object = object;
+    hazard.buffer = buffer;
+    hazard.level = level;
+    hazards.push_back(hazard);
+    return hazards.back();
+}
+
+void FrameGraph::barrierFor(const Pass& pass) {
+    // Read after write: the earlier write must be visible to this kind of access.
+    // Write after read or write: the earlier pass must be done with the memory, which
+    // matters most when aliasing hands a texture from one resource to the next.
+    GLbitfield bits = 0;
+    for (const Access& entry : pass.accesses) {
+        const Resource& resource = resources[entry.resource];
+        GLbitfield bit = barrierBit(entry.usage);
+
+        // Samplers can fetch from every level
+        for (const Hazard& hazard : hazards) {
+            if (hazard.object != resource.object || hazard.buffer != resource.buffer) continue;
+            if (entry.usage != Usage::Sampler && hazard.level != entry.level) continue;
+
+            if (entry.reads && hazard.written && !(hazard.visible & bit)) bits |= bit;
+            if (entry.writes && ((hazard.written && !(hazard.visible & bit)) || hazard.read)) bits |= bit;
+        }
+    }
+
+    if (bits) {
+        glMemoryBarrier(bits);
+        frameStats.barriers++;
+        for (Hazard& hazard : hazards) {
+            hazard.visible |= bits;
+            hazard.read = false;
+        }
+    }
+
+    for (const Access& entry : pass.accesses) {
+        const Resource& resource = resources[entry.resource];
+        Hazard& hazard = hazardFor(resource.object, resource.buffer, entry.level);
+        if (entry.writes) {
+            hazard.written = true;
+            hazard.visible = 0;
+            hazard.writeBits = resource.buffer
+                ? GL_SHADER_STORAGE_BARRIER_BIT
+                : GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT;
+        } else if (entry.reads) {
+            hazard.read = true;
+        }
+    }
+}
+
+void FrameGraph::bind(const Pass& pass) const {
+    for (const Access& entry : pass.accesses) {
+        GLuint object = resources[entry.resource].object;
+        switch (entry.usage) {
+            case Usage::Image: {
+                GLenum access = (entry.reads && entry.writes) ? GL_READ_WRITE
+                              : entry.writes ? GL_WRITE_ONLY : GL_READ_ONLY;
+                glBindImageTexture(entry.unit, object, entry.level, GL_FALSE, 0, access, entry.format);
+                break;
+            }
+            case Usage::Sampler:
+                glBindTextureUnit(entry.unit, object);
+                break;
+            case Usage::Storage:
+                glBindBufferBase(GL_SHADER_STORAGE_BUFFER, entry.unit, object);
+                break;
+        }
+    }
+}
+
+GLbitfield FrameGraph::barrierBit(Usage usage) {
+    switch (usage) {
+        case Usage::Image:   return GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+        case Usage::Sampler: return GL_TEXTURE_FETCH_BARRIER_BIT;
+        case Usage::Storage: return GL_SHADER_STORAGE_BARRIER_BIT;
+    }
+    return GL_ALL_BARRIER_BITS;
+}
+
+size_t FrameGraph::bytesPerTexel(GLenum format) {
+    switch (format) {
+        case GL_RGBA16F: return 8;
+        default:         return 4; // RGBA8, RGB10_A2, R11F_G11F_B10F, RG16F, R32F, RGBA8UI
+    }
+}
+
+}
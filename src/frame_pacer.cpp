@@ -0,0 +1,94 @@
+/*
+* File: frame_pacer.cpp
+* Project: Cisalpine Engine
+* Author: Collin Longoria
+* Created on: 10/16/2026
+*
+* Copyright (c) 2025 Collin Longoria
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+
+#include "frame_pacer.hpp"
+
+#include "GLFW/glfw3.h"
+#include <algorithm>
+
+namespace cisalpine {
+
+constexpr float PACER_SMOOTHING = 0.2f;
+constexpr GLuint64 FENCE_WAIT_NS = 100'000'000; // Re-check a stuck fence every 100 ms
+
+FramePacer::~FramePacer() {
+    release();
+}
+
+void FramePacer::setFramesInFlight(int count) {
+    count = std::clamp(count, 1, MAX_FRAMES_IN_FLIGHT);
+    if (count == frameCount) return;
+
+    // Slots are renumbered, so nothing may still be using one
+    release();
+    frameCount = count;
+    current = 0;
+}
+
+int FramePacer::beginFrame() {
+    // Frames that finished early report their latency now rather than when reused
+    for (Frame& frame : frames) {
+        retire(frame, false);
+    }
+
+    double start = glfwGetTime();
+    retire(frames[current], true);
+    float waitMs = static_cast<float>((glfwGetTime() - start) * 1000.0);
+    frameStats.waitMs += (waitMs - frameStats.waitMs) * PACER_SMOOTHING;
+
+    return current;
+}
+
+void FramePacer::reflectInput(double time) {
+    pendingInput = std::max(pendingInput, time);
+}
+
+void FramePacer::endFrame() {
+    Frame& frame = frames[current];
+    frame.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    frame.inputTime = pendingInput;
+    pendingInput = 0.0;
+
+    current = (current + 1) % frameCount;
+}
+
+void FramePacer::release() {
+    for (Frame& frame : frames) {
+        retire(frame, true);
+    }
+    current = 0;
+}
+
+bool FramePacer::retire(Frame& frame, bool wait) {
+    if (!frame.fence) return true;
+
+    // Flushing makes sure the fence reaches the GPU before we block on it
+    GLenum result = glClientWaitSync(frame.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    while (wait && result == GL_TIMEOUT_EXPIRED) {
+        result = glClientWaitSync(frame.fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_WAIT_NS);
+    }
+    if (result == GL_TIMEOUT_EXPIRED) return false;
+
+    if (frame.inputTime > 0.0 && result != GL_WAIT_FAILED) {
+        float latencyMs = static_cast<float>((glfwGetTime() - frame.inputTime) * 1000.0);
+        frameStats.latencyMs = (frameStats.latencyMs > 0.0f)
+            ? frameStats.latencyMs + (latencyMs - frameStats.latencyMs) * PACER_SMOOTHING
+            : latencyMs;
+    }
+
+    glDeleteSync(frame.fence);
+    frame.fence = nullptr;
+    frame.inputTime = 0.0;
+    return true;
+}
+
+}
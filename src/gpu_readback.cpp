@@ -0,0 +1,70 @@
+/*
+* File: gpu_readback.cpp
+* Project: Cisalpine Engine
+* Author: Collin Longoria
+* Created on: 10/16/2026
+*
+* Copyright (c) 2025 Collin Longoria
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+
+#include "gpu_readback.hpp"
+
+#include <cstring>
+
+namespace cisalpine {
+
+GpuReadback::~GpuReadback() {
+    for (GLsync fence : fences) {
+        if (fence) glDeleteSync(fence);
+    }
+    if (ringBuffer) {
+        glUnmapNamedBuffer(ringBuffer);
+        glDeleteBuffers(1, &ringBuffer);
+    }
+}
+
+bool GpuReadback::init(GLsizeiptr size, int depth) {
+    slotSize = size;
+    fences.assign(depth, nullptr);
+
+    // Persistent + coherent: results are visible to the CPU as soon as the fence signals
+    const GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glCreateBuffers(1, &ringBuffer);
+    glNamedBufferStorage(ringBuffer, slotSize * depth, nullptr, flags);
+    mapped = glMapNamedBufferRange(ringBuffer, 0, slotSize * depth, flags);
+
+    return mapped != nullptr;
+}
+
+bool GpuReadback::request(GLuint buffer, GLintptr offset) {
+    if (pendingCount == static_cast<int>(fences.size())) return false;
+
+    glCopyNamedBufferSubData(buffer, ringBuffer, offset, head * slotSize, slotSize);
+    fences[head] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    head = (head + 1) % static_cast<int>(fences.size());
+    pendingCount++;
+    return true;
+}
+
+bool GpuReadback::poll(void* dst) {
+    if (pendingCount == 0) return false;
+
+    int depth = static_cast<int>(fences.size());
+    int tail = (head - pendingCount + depth) % depth;
+
+    // Zero timeout: only ask whether it's done
+    GLenum status = glClientWaitSync(fences[tail], 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) return false;
+
+    std::memcpy(dst, static_cast<const char*>(mapped) + tail * slotSize, slotSize);
+    glDeleteSync(fences[tail]);
+    fences[tail] = nullptr;
+    pendingCount--;
+    return true;
+}
+
+}
@@ -0,0 +1,78 @@
+/*
+* File: gpu_timer.cpp
+* Project: Cisalpine Engine
+* Author: Collin Longoria
+* Created on: 10/16/2026
+*
+* Copyright (c) 2025 Collin Longoria
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+
+#include "gpu_timer.hpp"
+
+namespace cisalpine {
+
+GpuTimer::~GpuTimer() {
+    release();
+}
+
+bool GpuTimer::init(int depth) {
+    release();
+    queries.assign(depth * 2, 0);
+    glGenQueries(static_cast<GLsizei>(queries.size()), queries.data());
+    return queries[0] != 0;
+}
+
+void GpuTimer::release() {
+    if (!queries.empty()) {
+        glDeleteQueries(static_cast<GLsizei>(queries.size()), queries.data());
+        queries.clear();
+    }
+    head = 0;
+    pendingCount = 0;
+    open = false;
+}
+
+bool GpuTimer::begin() {
+    int depth = static_cast<int>(queries.size() / 2);
+    if (open || pendingCount == depth) return false;
+
+    glQueryCounter(queries[head * 2], GL_TIMESTAMP);
+    open = true;
+    return true;
+}
+
+void GpuTimer::end() {
+    if (!open) return;
+
+    int depth = static_cast<int>(queries.size() / 2);
+    glQueryCounter(queries[head * 2 + 1], GL_TIMESTAMP);
+    head = (head + 1) % depth;
+    pendingCount++;
+    open = false;
+}
+
+bool GpuTimer::poll(double& milliseconds) {
+    if (pendingCount == 0) return false;
+
+    int depth = static_cast<int>(queries.size() / 2);
+    int tail = (head - pendingCount + depth) % depth;
+
+    // The end query finishes last, so its availability covers both
+    GLint available = 0;
+    glGetQueryObjectiv(queries[tail * 2 + 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) return false;
+
+    GLuint64 start = 0;
+    GLuint64 stop = 0;
+    glGetQueryObjectui64v(queries[tail * 2], GL_QUERY_RESULT, &start);
+    glGetQueryObjectui64v(queries[tail * 2 + 1], GL_QUERY_RESULT, &stop);
+    milliseconds = static_cast<double>(stop - start) / 1.0e6;
+
+    pendingCount--;
+    return true;
+}
+
+}
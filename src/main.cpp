@@ -12,13 +12,32 @@
 
 #include <app.hpp>
 #include <iostream>
+#include <string>
 
-int main() {
+int main(int argc, char** argv) {
     cisalpine::App app;
 
+    // --benchmark [output.json] [--instrument]: run the simulation benchmark instead of the editor,
+    // optionally with per-step event counters (which add to the measured step time)
+    // --tune: retune workgroup sizes for this device before opening the editor
+    bool benchmark = argc > 1 && std::string(argv[1]) == "--benchmark";
+    bool tune = argc > 1 && std::string(argv[1]) == "--tune";
+    std::string benchmarkOutput = "benchmark.json";
+    bool instrument = false;
+    for (int i = 2; benchmark && i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--instrument") instrument = true;
+        else benchmarkOutput = arg;
+    }
+
     try {
         app.init(256,256);
-        app.run();
+        if (benchmark) {
+            app.runBenchmark(benchmarkOutput, instrument);
+        } else {
+            if (tune) app.tuneWorkgroups();
+            app.run();
+        }
         app.shutdown();
     }  catch (const std::exception& e) {
         std::cerr << "Fatal error: " << e.what() << std::endl;
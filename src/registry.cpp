@@ -51,7 +51,7 @@ void Registry::load(const std::string &filename) {
         d.lightRadius = 0.0f;
         d.lightIntensity = 0.0f;
         d.ior = 1.0f;
-        d._pad = 0;
+        d.dispersion = 1;
     }
 
     for (auto& [key, val] : j.items()) {
@@ -84,7 +84,7 @@ void Registry::load(const std::string &filename) {
         d.lightRadius = val.value("lightRadius", 0.0f);
         d.lightIntensity = val.value("lightIntensity", 0.0f);
         d.ior = val.value("ior", 1.45f); // default IOR for glass-like
-        d._pad = 0;
+        d.dispersion = val.value("dispersion", 1);
 
         // CPU-only properties
         singleClickFlags[id] = val.value("singleClick", false);
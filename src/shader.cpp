@@ -15,6 +15,7 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <filesystem>
 
 namespace cisalpine {
 
@@ -51,6 +52,39 @@ std::string Shader::readFile(std::string_view filePath) {
     return buffer.str();
 }
 
+std::string Shader::resolveIncludes(const std::string& source, std::string_view path, int depth) {
+    // GLSL has no include support, so expand #include "file" lines here.
+    // Paths are relative to the including file.
+    if (depth > 8) {
+        std::cerr << "Shader include depth exceeded in " << path << std::endl;
+        return source;
+    }
+
+    std::filesystem::path baseDir = std::filesystem::path(path).parent_path();
+    std::istringstream in(source);
+    std::string result;
+    std::string line;
+
+    while (std::getline(in, line)) {
+        size_t start = line.find_first_not_of(" \t");
+        if (start != std::string::npos && line.compare(start, 8, "#include") == 0) {
+            size_t open = line.find('"', start);
+            size_t close = (open != std::string::npos) ? line.find('"', open + 1) : std::string::npos;
+            if (open != std::string::npos && close != std::string::npos) {
+                std::string includePath = (baseDir / line.substr(open + 1, close - open - 1)).string();
+                std::string included = readFile(includePath);
+                result += resolveIncludes(included, includePath, depth + 1);
+                result += "\n";
+                continue;
+            }
+        }
+        result += line;
+        result += "\n";
+    }
+
+    return result;
+}
+
 GLuint Shader::compileShader(GLenum type, const std::string& source, std::string_view path) {
     GLuint shader = glCreateShader(type);
     const char* src = source.c_str();
@@ -130,6 +164,7 @@ bool Shader::loadCompute(std::string_view computePath, const std::string& header
     if (source.empty()) {
         return false;
     }
+    source = resolveIncludes(source, computePath);
 
     // Inject header after version string
     size_t versionPos = source.find("#version");
@@ -188,6 +223,10 @@ void Shader::setVec2(std::string_view name, float x, float y) const {
     glUniform2f(glGetUniformLocation(programId, name.data()), x, y);
 }
 
+void Shader::setIVec2(std::string_view name, int x, int y) const {
+    glUniform2i(glGetUniformLocation(programId, name.data()), x, y);
+}
+
 void Shader::setVec4(std::string_view name, float x, float y, float z, float w) const {
     glUniform4f(glGetUniformLocation(programId, name.data()), x, y, z, w);
 }
@@ -0,0 +1,211 @@
+/*
+* File: simulation.cpp
+* Project: Cisalpine Engine
+* Author: Collin Longoria
+* Created on: 10/16/2026
+*
+* Copyright (c) 2025 Collin Longoria
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+
+#include "simulation.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace cisalpine {
+
+namespace {
+
+// Snapshot layout: magic, version, width, height, element count, names
+// (length-prefixed), then width * height RGBA8UI cells. Integers are little-endian uint32.
+constexpr char SNAPSHOT_MAGIC[4] = {'C', 'S', 'L', 'W'};
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+// Limits on what a snapshot header may claim; element ids are the state's 8-bit R channel
+constexpr uint32_t SNAPSHOT_MAX_ELEMENTS = 256;
+constexpr uint32_t SNAPSHOT_MAX_NAME = 256;
+
+void writeU32(std::ofstream& file, uint32_t value) {
+    uint8_t bytes[4] = {
+        static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8),
+        static_cast<uint8_t>(value >> 16), static_cast<uint8_t>(value >> 24)};
+    file.write(reinterpret_cast<const char*>(bytes), 4);
+}
+
+bool readU32(std::ifstream& file, uint32_t& value) {
+    uint8_t bytes[4];
+    if (!file.read(reinterpret_cast<char*>(bytes), 4)) return false;
+    value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+    return true;
+}
+
+}
+
+bool Simulation::loadGL(GLADloadproc loader) {
+    if (!gladLoadGLLoader(loader)) {
+        std::cerr << "Failed to load OpenGL functions" << std::endl;
+        return false;
+    }
+    if (!GLAD_GL_VERSION_4_6) {
+        std::cerr << "Cisalpine needs OpenGL 4.6" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Simulation::init(const SimulationOptions& options) {
+    try {
+        registryData.load(options.registryPath);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return false;
+    }
+    settings = options.settings;
+    return createWorld(options.width, options.height);
+}
+
+bool Simulation::createWorld(int width, int height) {
+    auto created = std::make_unique<World>(width, height);
+    if (!created->init(registryData.getShaderHeader())) {
+        std::cerr << "Failed to initialize world" << std::endl;
+        return false;
+    }
+    created->simulationSettings() = settings;
+    worldPtr = std::move(created);
+    return true;
+}
+
+void Simulation::step(int steps) {
+    // Other simulations sharing the context may have bound their own registry
+    registryData.bindSSBO(2);
+    worldPtr->step(steps);
+}
+
+bool Simulation::paint(int x, int y, int radius, int shape, const std::string& element) {
+    int id = registryData.getId(element);
+    if (id < 0) return false;
+    worldPtr->paint(x, y, radius, shape, static_cast<uint32_t>(id), false);
+    return true;
+}
+
+void Simulation::erase(int x, int y, int radius, int shape) {
+    worldPtr->paint(x, y, radius, shape, 0, true);
+}
+
+void Simulation::clear() {
+    worldPtr->clear();
+}
+
+void Simulation::queryRegion(int x, int y, int w, int h, std::vector<uint8_t>& cells) const {
+    int x0 = std::clamp(x, 0, width());
+    int y0 = std::clamp(y, 0, height());
+    int x1 = std::clamp(x + w, 0, width());
+    int y1 = std::clamp(y + h, 0, height());
+    if (x1 <= x0 || y1 <= y0) {
+        cells.clear();
+        return;
+    }
+    worldPtr->readCells(x0, y0, x1 - x0, y1 - y0, cells);
+}
+
+bool Simulation::save(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open snapshot for writing: " << path << std::endl;
+        return false;
+    }
+
+    std::vector<uint8_t> cells;
+    worldPtr->readCells(0, 0, width(), height(), cells);
+
+    const std::vector<std::string>& names = registryData.getNames();
+    file.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    writeU32(file, SNAPSHOT_VERSION);
+    writeU32(file, static_cast<uint32_t>(width()));
+    writeU32(file, static_cast<uint32_t>(height()));
+    writeU32(file, static_cast<uint32_t>(names.size()));
+    for (const std::string& name : names) {
+        writeU32(file, static_cast<uint32_t>(name.size()));
+        file.write(name.data(), static_cast<std::streamsize>(name.size()));
+    }
+    file.write(reinterpret_cast<const char*>(cells.data()), static_cast<std::streamsize>(cells.size()));
+    return file.good();
+}
+
+bool Simulation::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open snapshot: " << path << std::endl;
+        return false;
+    }
+
+    char magic[4];
+    uint32_t version = 0, w = 0, h = 0, nameCount = 0;
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0 ||
+        !readU32(file, version) || version != SNAPSHOT_VERSION ||
+        !readU32(file, w) || !readU32(file, h) || !readU32(file, nameCount)) {
+        std::cerr << "Not a world snapshot: " << path << std::endl;
+        return false;
+    }
+
+    GLint maxSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    if (w == 0 || h == 0 || w > static_cast<uint32_t>(maxSize) || h > static_cast<uint32_t>(maxSize) ||
+        nameCount > SNAPSHOT_MAX_ELEMENTS) {
+        std::cerr << "Corrupt world snapshot header: " << path << std::endl;
+        return false;
+    }
+
+    // Saved id -> id in this registry; unknown elements load as empty
+    std::vector<uint8_t> remap(256, 0);
+    for (uint32_t id = 0; id < nameCount; id++) {
+        uint32_t length = 0;
+        if (!readU32(file, length) || length > SNAPSHOT_MAX_NAME) {
+            std::cerr << "Corrupt world snapshot element table: " << path << std::endl;
+            return false;
+        }
+        std::string name(length, '\0');
+        if (!file.read(name.data(), length)) return false;
+
+        int mapped = name.empty() ? -1 : registryData.getId(name);
+        if (id < remap.size() && mapped >= 0) remap[id] = static_cast<uint8_t>(mapped);
+    }
+
+    // Check the cells are all there before allocating for them
+    size_t cellBytes = static_cast<size_t>(w) * h * 4;
+    std::streamoff start = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::streamoff available = file.tellg() - start;
+    file.seekg(start);
+    if (start < 0 || available < static_cast<std::streamoff>(cellBytes)) {
+        std::cerr << "Truncated world snapshot: " << path << std::endl;
+        return false;
+    }
+
+    std::vector<uint8_t> cells(cellBytes);
+    if (!file.read(reinterpret_cast<char*>(cells.data()), static_cast<std::streamsize>(cells.size()))) {
+        std::cerr << "Truncated world snapshot: " << path << std::endl;
+        return false;
+    }
+    for (size_t i = 0; i < cells.size(); i += 4) {
+        uint8_t mapped = remap[cells[i]];
+        if (mapped == 0 && cells[i] != 0) {
+            // Dropped element: clear the whole cell, not just its id
+            cells[i + 1] = cells[i + 2] = cells[i + 3] = 0;
+        }
+        cells[i] = mapped;
+    }
+
+    if (static_cast<int>(w) != width() || static_cast<int>(h) != height()) {
+        if (!createWorld(static_cast<int>(w), static_cast<int>(h))) return false;
+    }
+    worldPtr->writeCells(0, 0, static_cast<int>(w), static_cast<int>(h), cells);
+    return true;
+}
+
+}
@@ -0,0 +1,121 @@
+/*
+* File: simulation_thread.cpp
+* Project: Cisalpine Engine
+* Author: Collin Longoria
+* Created on: 10/16/2026
+*
+* Copyright (c) 2025 Collin Longoria
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+
+#include "simulation_thread.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace cisalpine {
+
+SimulationThread::~SimulationThread() {
+    stop();
+}
+
+bool SimulationThread::start(GLFWwindow* mainWindow, World& target, const Registry& elements) {
+    if (running()) return true;
+
+    world = &target;
+    registry = &elements;
+
+    // Hidden 1x1 window whose context shares textures, buffers, programs and fences
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    context = glfwCreateWindow(1, 1, "Cisalpine Simulation", nullptr, mainWindow);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+    if (!context) {
+        std::cerr << "Failed to create shared simulation context, simulating on the main thread" << std::endl;
+        return false;
+    }
+
+    // Queries stay with the context that made them
+    world->releaseSimulationContext();
+    world->setThreaded(true);
+
+    quit.store(false);
+    worker = std::thread(&SimulationThread::loop, this);
+    return true;
+}
+
+void SimulationThread::stop() {
+    if (!running()) return;
+
+    quit.store(true);
+    worker.join();
+
+    // Anything submitted after the last drain still applies, now on this thread
+    SimulationCommand command;
+    while (commands.pop(command)) {
+        apply(command);
+    }
+
+    world->setThreaded(false);
+    world->attachSimulationContext();
+
+    glfwDestroyWindow(context);
+    context = nullptr;
+}
+
+bool SimulationThread::submit(const SimulationCommand& command) {
+    if (!running()) {
+        apply(command);
+        return true;
+    }
+    return commands.push(command);
+}
+
+void SimulationThread::loop() {
+    glfwMakeContextCurrent(context);
+
+    // Binding points are per-context state
+    registry->bindSSBO(2);
+    world->attachSimulationContext();
+
+    using Clock = std::chrono::steady_clock;
+    auto lastTime = Clock::now();
+
+    while (!quit.load()) {
+        SimulationCommand command;
+        while (commands.pop(command)) {
+            apply(command);
+        }
+
+        auto now = Clock::now();
+        float dt = std::min(std::chrono::duration<float>(now - lastTime).count(), 0.1f);
+        lastTime = now;
+
+        world->update(dt);
+
+        // Steps come due every FIXED_TIMESTEP; yield between them instead of spinning.
+        // A settled world only waits for commands, so it can nap longer.
+        std::this_thread::sleep_for(std::chrono::milliseconds(world->isIdle() ? 5 : 1));
+    }
+
+    glFinish();
+    world->releaseSimulationContext();
+    glfwMakeContextCurrent(nullptr);
+}
+
+void SimulationThread::apply(const SimulationCommand& command) {
+    if (const auto* paint = std::get_if<PaintCommand>(&command)) {
+        world->paint(paint->x, paint->y, paint->radius, paint->shape, paint->element, paint->erase);
+        world->markInput(paint->inputTime);
+    } else if (std::holds_alternative<ClearCommand>(command)) {
+        world->clear();
+    } else if (std::holds_alternative<WakeCommand>(command)) {
+        world->wake();
+    } else if (const auto* settings = std::get_if<SettingsCommand>(&command)) {
+        world->simulationSettings() = settings->settings;
+    }
+}
+
+}
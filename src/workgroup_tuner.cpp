@@ -0,0 +1,174 @@
+/*
+* File: workgroup_tuner.cpp
+* Project: Cisalpine Engine
+* Author: Collin Longoria
+* Created on: 10/16/2026
+*
+* Copyright (c) 2025 Collin Longoria
+*
+* This software is released under the MIT License.
+* https://opensource.org/licenses/MIT
+*/
+
+#include "workgroup_tuner.hpp"
+
+#include "world.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace cisalpine {
+
+// Work timed per candidate; enough to dwarf query overhead on small worlds
+constexpr int TUNE_STEPS = 20;
+constexpr int TUNE_FRAMES = 8;
+constexpr int TUNE_COUNTS = 16;
+
+std::string deviceString() {
+    auto glString = [](GLenum name) {
+        const char* value = reinterpret_cast<const char*>(glGetString(name));
+        return std::string(value ? value : "unknown");
+    };
+    return glString(GL_VENDOR) + " / " + glString(GL_RENDERER) + " / " + glString(GL_VERSION);
+}
+
+// GPU milliseconds the kernel's own dispatches took over one run of work, after an
+// untimed run to settle caches and clocks. Other passes of the run are not counted.
+static double timeKernel(World& world, Kernel kernel, const std::function<void()>& work) {
+    work();
+
+    world.beginKernelTiming(kernel);
+    work();
+    return world.endKernelTiming();
+}
+
+static void renderFrames(World& world) {
+    for (int i = 0; i < TUNE_FRAMES; i++) {
+        world.wake(); // A settled world would reuse its last frame
+        world.render(0, 0, world.width(), world.height());
+    }
+}
+
+WorkgroupTuning tuneWorkgroups(World& world, const std::function<void(World&)>& setup) {
+    WorkgroupTuning tuning;
+
+    SimulationSettings savedSimulation = world.simulationSettings();
+    RenderSettings savedRender = world.renderSettings();
+
+    // Fixed work per measurement: no governor, no idling, full frames at full resolution
+    world.simulationSettings().stepGovernor = false;
+    world.simulationSettings().idleWhenSettled = false;
+    world.renderSettings().dynamicResolution = false;
+    world.renderSettings().dirtyTracking = false;
+
+    ElementPopulation counts;
+    for (int k = 0; k < KERNEL_COUNT; k++) {
+        Kernel kernel = static_cast<Kernel>(k);
+
+        // Settings under which the kernel runs every step or frame: render.comp's color pass
+        // only runs on the split path, and cascades need glow
+        world.simulationSettings().engine = (kernel == Kernel::Margolus) ? SimulationEngine::Margolus
+                                                                          : SimulationEngine::Gather;
+        world.renderSettings().fusedComposite = (kernel == Kernel::Render) ? false : savedRender.fusedComposite;
+        world.renderSettings().glowEnabled = (kernel == Kernel::Cascades) ? true : savedRender.glowEnabled;
+        world.renderSettings().lightingModel = (kernel == Kernel::Cascades) ? LightingModel::RadianceCascades
+                                             : (kernel == Kernel::Render) ? LightingModel::Bounce
+                                                                          : savedRender.lightingModel;
+
+        double bestMs = -1.0;
+        for (size_t c = 0; c < WORKGROUP_CANDIDATES.size(); c++) {
+            double& ms = tuning.candidateMs[k][c];
+            ms = -1.0;
+            if (!world.setWorkgroupSize(kernel, WORKGROUP_CANDIDATES[c])) continue;
+
+            world.clear();
+            setup(world);
+            switch (kernel) {
+                case Kernel::Simulation:
+                case Kernel::Margolus:
+                    ms = timeKernel(world, kernel, [&] { world.step(TUNE_STEPS); });
+                    break;
+                case Kernel::Render:
+                case Kernel::Composite:
+                case Kernel::Cascades:
+                    ms = timeKernel(world, kernel, [&] { renderFrames(world); });
+                    break;
+                case Kernel::Population:
+                    ms = timeKernel(world, kernel, [&] { for (int i = 0; i < TUNE_COUNTS; i++) world.countElements(counts); });
+                    break;
+            }
+
+            if (ms >= 0.0 && (bestMs < 0.0 || ms < bestMs)) {
+                bestMs = ms;
+                tuning.sizes[k] = WORKGROUP_CANDIDATES[c];
+            }
+        }
+
+        // Later kernels are measured with this one at its best
+        world.setWorkgroupSize(kernel, tuning.sizes[k]);
+    }
+
+    world.simulationSettings() = savedSimulation;
+    world.renderSettings() = savedRender;
+    world.clear();
+    return tuning;
+}
+
+bool loadWorkgroupCache(const std::string& path, const std::string& device, WorkgroupSizes& sizes) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+
+    // A damaged cache only costs a retune; a bad shape only falls back to the default
+    nlohmann::json cache = nlohmann::json::parse(file, nullptr, false);
+    if (cache.is_discarded() || !cache.is_object() || !cache.contains(device)) return false;
+
+    const nlohmann::json& entry = cache[device];
+    WorkgroupSizes loaded = defaultWorkgroupSizes();
+    for (int k = 0; k < KERNEL_COUNT; k++) {
+        if (!entry.contains(KERNEL_NAMES[k])) continue;
+        const nlohmann::json& shape = entry[KERNEL_NAMES[k]];
+        if (!shape.is_array() || shape.size() != 2 || !shape[0].is_number_integer() || !shape[1].is_number_integer()) {
+            continue;
+        }
+        // Only shapes the tuner produces; zero, negative or oversized ones would not build or dispatch
+        WorkgroupSize size{shape[0].get<int>(), shape[1].get<int>()};
+        if (std::find(WORKGROUP_CANDIDATES.begin(), WORKGROUP_CANDIDATES.end(), size) == WORKGROUP_CANDIDATES.end()) {
+            std::cerr << "Ignoring cached workgroup " << size.x << "x" << size.y << " for " << KERNEL_NAMES[k] << std::endl;
+            continue;
+        }
+        loaded[k] = size;
+    }
+    sizes = loaded;
+    return true;
+}
+
+bool saveWorkgroupCache(const std::string& path, const std::string& device, const WorkgroupSizes& sizes) {
+    nlohmann::json cache = nlohmann::json::object();
+    {
+        std::ifstream existing(path);
+        if (existing.is_open()) {
+            nlohmann::json parsed = nlohmann::json::parse(existing, nullptr, false);
+            if (!parsed.is_discarded() && parsed.is_object()) cache = parsed;
+        }
+    }
+    cache[device] = toJson(sizes);
+
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Failed to write workgroup cache: " << path << std::endl;
+        return false;
+    }
+    file << cache.dump(2) << std::endl;
+    return true;
+}
+
+nlohmann::json toJson(const WorkgroupSizes& sizes) {
+    nlohmann::json json = nlohmann::json::object();
+    for (int k = 0; k < KERNEL_COUNT; k++) {
+        json[KERNEL_NAMES[k]] = {sizes[k].x, sizes[k].y};
+    }
+    return json;
+}
+
+}
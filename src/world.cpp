@@ -11,42 +11,222 @@
 */
 
 #include "world.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <initializer_list>
 #include <iostream>
+#include <utility>
 #include <vector>
 
 namespace cisalpine {
 
+// Settings that change what the bounce solve produces; any change throws away the temporal history
+static bool lightingInputsChanged(const RenderSettings& a, const RenderSettings& b) {
+    return a.glowEnabled != b.glowEnabled ||
+           a.glowIntensity != b.glowIntensity ||
+           a.glowRadius != b.glowRadius ||
+           a.ambientLight != b.ambientLight ||
+           a.lightBounces != b.lightBounces ||
+           a.shadowMaps != b.shadowMaps ||
+           a.shadowMapLights != b.shadowMapLights ||
+           a.temporalSlices != b.temporalSlices;
+}
+
+// Settings that change the displayed image; any change forces a full redraw under dirty tracking
+static bool displayInputsChanged(const RenderSettings& a, const RenderSettings& b) {
+    return lightingInputsChanged(a, b) ||
+           a.backgroundColor.r != b.backgroundColor.r ||
+           a.backgroundColor.g != b.backgroundColor.g ||
+           a.backgroundColor.b != b.backgroundColor.b ||
+           a.backgroundColor.a != b.backgroundColor.a ||
+           a.specularStrength != b.specularStrength ||
+           a.lightingModel != b.lightingModel ||
+           a.lightingScale != b.lightingScale ||
+           a.fusedComposite != b.fusedComposite ||
+           a.dirtyTracking != b.dirtyTracking ||
+           a.animatedEffects != b.animatedEffects ||
+           a.temporalLighting != b.temporalLighting ||
+           a.minimap != b.minimap ||
+           a.activityOverlay != b.activityOverlay;
+}
+
+// Classes of a Margolus block cell (CLASS_* in simulation_margolus.comp)
+enum BlockClass { BLOCK_EMPTY, BLOCK_GAS, BLOCK_LIQUID, BLOCK_OTHER };
+constexpr int MARGOLUS_RULE_BITS = 15;
+
+// Rearrangement of one Margolus block for every rule index. Index bits: 0-7 the four
+// cells' classes, 8-11 whether top cell 2 or 3 falls into cell 0 or 1 (2->0, 3->1,
+// 2->1, 3->0), 12 diagonal order, 13-14 whether the bottom / top row's fluid spreads.
+// Rule byte: cell i of the result is cell (rule >> 2i) & 3 of the block.
+// Cells first fall straight down (or gas rises into empty above), then unmoved top cells
+// slide down a diagonal, then unmoved rows let a liquid or gas step into empty beside it.
+static uint8_t margolusRule(int index) {
+    int classes[4];
+    for (int i = 0; i < 4; i++) classes[i] = (index >> (2 * i)) & 3;
+    bool falls[4][4] = {}; // [top][target]
+    falls[2][0] = (index >> 8) & 1;
+    falls[3][1] = (index >> 9) & 1;
+    falls[2][1] = (index >> 10) & 1;
+    falls[3][0] = (index >> 11) & 1;
+    bool flip = (index >> 12) & 1;
+    bool spreads[2] = { ((index >> 13) & 1) != 0, ((index >> 14) & 1) != 0 };
+
+    int source[4] = {0, 1, 2, 3};
+    bool moved[4] = {};
+    auto swapCells = [&](int a, int b) {
+        std::swap(source[a], source[b]);
+        moved[a] = true;
+        moved[b] = true;
+    };
+
+    auto vertical = [&](int bottom, int top) {
+        if (falls[top][bottom] || (classes[bottom] == BLOCK_GAS && classes[top] == BLOCK_EMPTY)) {
+            swapCells(bottom, top);
+        }
+    };
+    auto diagonal = [&](int top, int below, int target) {
+        if (moved[top] || moved[target]) return false;
+        if (falls[top][below] || !falls[top][target]) return false;
+        swapCells(top, target);
+        return true;
+    };
+    auto sideways = [&](int a, int b, bool spread) {
+        if (moved[a] || moved[b] || !spread) return;
+        if ((classes[a] == BLOCK_EMPTY) == (classes[b] == BLOCK_EMPTY)) return;
+        int mover = (classes[a] == BLOCK_EMPTY) ? b : a;
+        if (classes[mover] == BLOCK_LIQUID || classes[mover] == BLOCK_GAS) swapCells(a, b);
+    };
+
+    vertical(0, 2);
+    vertical(1, 3);
+    if (!flip) {
+        if (!diagonal(2, 0, 1)) diagonal(3, 1, 0);
+    } else {
+        if (!diagonal(3, 1, 0)) diagonal(2, 0, 1);
+    }
+    sideways(0, 1, spreads[0]);
+    sideways(2, 3, spreads[1]);
+
+    uint8_t rule = 0;
+    for (int i = 0; i < 4; i++) rule |= static_cast<uint8_t>(source[i] << (2 * i));
+    return rule;
+}
+
+// Every rule, packed four to a uint for the MargolusRules SSBO
+static std::vector<uint32_t> buildMargolusRules() {
+    std::vector<uint32_t> rules((1 << MARGOLUS_RULE_BITS) / 4, 0);
+    for (int index = 0; index < (1 << MARGOLUS_RULE_BITS); index++) {
+        rules[index / 4] |= static_cast<uint32_t>(margolusRule(index)) << ((index % 4) * 8);
+    }
+    return rules;
+}
+
+// Whether the context advertises an extension (e.g. for optional shader variants)
+static bool hasExtension(const char* name) {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; i++) {
+        const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (extension && std::strcmp(extension, name) == 0) return true;
+    }
+    return false;
+}
+
 World::World(int width, int height)
     : worldWidth(width), worldHeight(height) {
 }
 
 World::~World() {
     if (stateTextures[0]) glDeleteTextures(2, stateTextures);
+    for (PublishedState& slot : published) {
+        if (slot.texture) glDeleteTextures(1, &slot.texture);
+        if (slot.heat) glDeleteTextures(1, &slot.heat);
+        if (slot.written) glDeleteSync(slot.written);
+        if (slot.read) glDeleteSync(slot.read);
+    }
     if (colorTexture) glDeleteTextures(1, &colorTexture);
     if (normalTexture) glDeleteTextures(1, &normalTexture);
     if (lightmapTexture) glDeleteTextures(1, &lightmapTexture);
     if (lightmapPingPong) glDeleteTextures(1, &lightmapPingPong);
     if (displayTexture) glDeleteTextures(1, &displayTexture);
+    if (occupancyTexture) glDeleteTextures(1, &occupancyTexture);
+    if (overviewTexture) glDeleteTextures(1, &overviewTexture);
+    if (minimapTexture) glDeleteTextures(1, &minimapTexture);
+    if (shadowMapTexture) glDeleteTextures(1, &shadowMapTexture);
+    if (shadowLightBuffer) glDeleteBuffers(1, &shadowLightBuffer);
+    if (lightCandidateBuffer) glDeleteBuffers(1, &lightCandidateBuffer);
+    if (lightHistoryTexture) glDeleteTextures(1, &lightHistoryTexture);
+    if (temporalTileBuffer) glDeleteBuffers(1, &temporalTileBuffer);
+    if (dirtyTileBuffer) glDeleteBuffers(1, &dirtyTileBuffer);
+    if (renderTileBuffer) glDeleteBuffers(1, &renderTileBuffer);
+    if (activityBuffer) glDeleteBuffers(1, &activityBuffer);
+    if (populationBuffer) glDeleteBuffers(1, &populationBuffer);
+    if (margolusRuleBuffer) glDeleteBuffers(1, &margolusRuleBuffer);
+    if (simCounterBuffer) glDeleteBuffers(1, &simCounterBuffer);
+    if (tileChangeBuffer) glDeleteBuffers(1, &tileChangeBuffer);
+    if (activityHeatTexture) glDeleteTextures(1, &activityHeatTexture);
     if (quadVAO) glDeleteVertexArrays(1, &quadVAO);
     if (quadVBO) glDeleteBuffers(1, &quadVBO);
 }
 
-bool World::init(const std::string& shaderHeader) {
-    // Load shaders
-    if (!simulationShader.loadCompute("shaders/simulation.comp", shaderHeader)) {
-        std::cerr << "Failed to load simulation shader" << std::endl;
+bool World::init(const std::string& elementHeader) {
+    // Engine constants shared with the shaders
+    shaderHeader = elementHeader;
+    shaderHeader += "#define MAX_SHADOW_LIGHTS " + std::to_string(MAX_SHADOW_LIGHTS) + "\n";
+    shaderHeader += "#define SHADOW_MAP_RESOLUTION " + std::to_string(SHADOW_MAP_RESOLUTION) + "\n";
+    shaderHeader += "#define MAX_LIGHT_CANDIDATES " + std::to_string(MAX_LIGHT_CANDIDATES) + "\n";
+    shaderHeader += "#define LIGHT_BLOCK_SIZE " + std::to_string(LIGHT_BLOCK_SIZE) + "\n";
+    shaderHeader += "#define DIRTY_TILE_SIZE " + std::to_string(DIRTY_TILE_SIZE) + "\n";
+    shaderHeader += "#define POPULATION_BINS " + std::to_string(POPULATION_BINS) + "\n";
+    shaderHeader += "#define SIM_COUNTERS " + std::to_string(SIM_COUNTERS) + "\n";
+
+    // Load shaders; 2D passes without a tuned shape run DEFAULT_WORKGROUP
+    if (!loadStepShaders()) {
         return false;
     }
-    if (!renderShader.loadCompute("shaders/render.comp", shaderHeader)) {
-        std::cerr << "Failed to load render shader" << std::endl;
+    std::string header = shaderHeader + workgroupDefines(DEFAULT_WORKGROUP);
+    if (!occupancyShader.loadCompute("shaders/occupancy.comp", header)) {
+        std::cerr << "Failed to load occupancy shader" << std::endl;
         return false;
     }
-    if (!lightingShader.loadCompute("shaders/lighting.comp", shaderHeader)) {
-        std::cerr << "Failed to load lighting shader" << std::endl;
+    if (!shadowGatherShader.loadCompute("shaders/shadow_gather.comp", header)) {
+        std::cerr << "Failed to load shadow gather shader" << std::endl;
         return false;
     }
-    if (!compositeShader.loadCompute("shaders/composite.comp", shaderHeader)) {
-        std::cerr << "Failed to load composite shader" << std::endl;
+    if (!shadowSelectShader.loadCompute("shaders/shadow_select.comp", shaderHeader)) {
+        std::cerr << "Failed to load shadow select shader" << std::endl;
+        return false;
+    }
+    if (!shadowMapShader.loadCompute("shaders/shadow_map.comp", shaderHeader)) {
+        std::cerr << "Failed to load shadow map shader" << std::endl;
+        return false;
+    }
+    if (!temporalTilesShader.loadCompute("shaders/temporal_tiles.comp", shaderHeader)) {
+        std::cerr << "Failed to load temporal tiles shader" << std::endl;
+        return false;
+    }
+    if (!brushShader.loadCompute("shaders/brush.comp", header)) {
+        std::cerr << "Failed to load brush shader" << std::endl;
+        return false;
+    }
+    if (!dirtyDilateShader.loadCompute("shaders/dirty_dilate.comp", header)) {
+        std::cerr << "Failed to load dirty dilate shader" << std::endl;
+        return false;
+    }
+    if (!stateDownsampleShader.loadCompute("shaders/state_downsample.comp", header)) {
+        std::cerr << "Failed to load state downsample shader" << std::endl;
+        return false;
+    }
+    if (!minimapShader.loadCompute("shaders/minimap.comp", header)) {
+        std::cerr << "Failed to load minimap shader" << std::endl;
+        return false;
+    }
+    if (!activityHeatShader.loadCompute("shaders/activity_heat.comp", header)) {
+        std::cerr << "Failed to load activity heat shader" << std::endl;
+        return false;
+    }
+    if (!loadFormatShaders()) {
         return false;
     }
     if (!quadShader.loadFromFile("shaders/quad.vert", "shaders/quad.frag")) {
@@ -57,9 +237,263 @@ bool World::init(const std::string& shaderHeader) {
     createTextures();
     createQuad();
 
+    // Margolus block rules, fixed for the life of the world
+    std::vector<uint32_t> rules = buildMargolusRules();
+    glGenBuffers(1, &margolusRuleBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, margolusRuleBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, rules.size() * sizeof(uint32_t), rules.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    if (!activityReadback.init(sizeof(uint32_t))) {
+        std::cerr << "Failed to map activity readback buffer" << std::endl;
+        return false;
+    }
+    if (!simCounterReadback.init(SIM_COUNTERS * sizeof(uint32_t))) {
+        std::cerr << "Failed to map instrumentation readback buffer" << std::endl;
+        return false;
+    }
+    if (!populationReadback.init(sizeof(ElementPopulation))) {
+        std::cerr << "Failed to map population readback buffer" << std::endl;
+        return false;
+    }
+
+    if (!stepTimer.init() || !renderTimer.init() || !reactionTimer.init()) {
+        std::cerr << "Failed to create GPU timer queries" << std::endl;
+        return false;
+    }
+
     return true;
 }
 
+// GLSL image format qualifier for a texture format
+static const char* imageFormatQualifier(GLenum format) {
+    switch (format) {
+        case GL_R11F_G11F_B10F: return "r11f_g11f_b10f";
+        case GL_RGB10_A2:       return "rgb10_a2";
+        case GL_RGBA8:          return "rgba8";
+        default:                return "rgba16f";
+    }
+}
+
+static size_t bytesPerTexel(GLenum format) {
+    switch (format) {
+        case GL_RGBA16F: return 8;
+        default:         return 4; // RGBA8, RGB10_A2, R11F_G11F_B10F, RG16F, R32F, RGBA8UI
+    }
+}
+
+bool World::loadStepShaders() {
+    // Build into temporaries so a failed reload keeps the working set
+    Shader simulation, reaction, margolus, instrumentedSimulation, instrumentedReaction, instrumentedMargolus, population;
+
+    std::string header = shaderHeader + workgroupDefines(workgroups[static_cast<int>(Kernel::Simulation)]);
+    std::string blockHeader = shaderHeader + workgroupDefines(workgroups[static_cast<int>(Kernel::Margolus)]);
+    if (!simulation.loadCompute("shaders/simulation.comp", header)) {
+        std::cerr << "Failed to load simulation shader" << std::endl;
+        return false;
+    }
+    if (!reaction.loadCompute("shaders/simulation.comp", header + "#define REACTIONS_ONLY\n")) {
+        std::cerr << "Failed to load reaction shader" << std::endl;
+        return false;
+    }
+    if (!margolus.loadCompute("shaders/simulation_margolus.comp", blockHeader)) {
+        std::cerr << "Failed to load Margolus shader" << std::endl;
+        return false;
+    }
+    if (!instrumentedSimulation.loadCompute("shaders/simulation.comp", header + "#define SIM_INSTRUMENTATION\n") ||
+        !instrumentedReaction.loadCompute("shaders/simulation.comp", header + "#define SIM_INSTRUMENTATION\n#define REACTIONS_ONLY\n") ||
+        !instrumentedMargolus.loadCompute("shaders/simulation_margolus.comp", blockHeader + "#define SIM_INSTRUMENTATION\n")) {
+        std::cerr << "Failed to load instrumented simulation shaders" << std::endl;
+        return false;
+    }
+
+    // Subgroup ballots where the driver has them, plain shared atomics otherwise
+    std::string populationHeader = shaderHeader + workgroupDefines(workgroups[static_cast<int>(Kernel::Population)]);
+    if (!(hasExtension("GL_KHR_shader_subgroup") && population.loadCompute("shaders/population.comp", populationHeader)) &&
+        !population.loadCompute("shaders/population.comp", populationHeader + "#define NO_SUBGROUPS\n")) {
+        std::cerr << "Failed to load population shader" << std::endl;
+        return false;
+    }
+
+    simulationShader = std::move(simulation);
+    reactionShader = std::move(reaction);
+    margolusShader = std::move(margolus);
+    instrumentedSimulationShader = std::move(instrumentedSimulation);
+    instrumentedReactionShader = std::move(instrumentedReaction);
+    instrumentedMargolusShader = std::move(instrumentedMargolus);
+    populationShader = std::move(population);
+    return true;
+}
+
+bool World::setWorkgroupSize(Kernel kernel, WorkgroupSize size) {
+    WorkgroupSizes sizes = workgroups;
+    sizes[static_cast<int>(kernel)] = size;
+    return setWorkgroupSizes(sizes);
+}
+
+bool World::setWorkgroupSizes(const WorkgroupSizes& sizes) {
+    auto changed = [&](std::initializer_list<Kernel> kernels) {
+        for (Kernel kernel : kernels) {
+            if (sizes[static_cast<int>(kernel)] != workgroups[static_cast<int>(kernel)]) return true;
+        }
+        return false;
+    };
+    // Only rebuild the shader set whose shapes moved; the tuner changes one kernel at a time
+    bool stepChanged = changed({Kernel::Simulation, Kernel::Margolus, Kernel::Population});
+    bool formatChanged = changed({Kernel::Render, Kernel::Composite, Kernel::Cascades});
+
+    WorkgroupSizes previous = workgroups;
+    workgroups = sizes;
+    bool stepLoaded = !stepChanged || loadStepShaders();
+    if (!stepLoaded || (formatChanged && !loadFormatShaders())) {
+        // Failed loaders keep their old shaders; rebuild the rest with the old shapes too
+        workgroups = previous;
+        if (stepChanged && stepLoaded) loadStepShaders();
+        return false;
+    }
+    displayValid = false;
+    return true;
+}
+
+bool World::loadFormatShaders() {
+    // Shaders that touch the lightmap, normal or display images are compiled per format
+    std::string header = shaderHeader;
+    header += std::string("#define LIGHTMAP_FORMAT ") + imageFormatQualifier(lightmapFormat) + "\n";
+    header += std::string("#define NORMAL_FORMAT ") + imageFormatQualifier(normalFormat) + "\n";
+    header += std::string("#define DISPLAY_FORMAT ") + imageFormatQualifier(displayFormat) + "\n";
+    if (normalFormat == GL_RGBA8) {
+        header += "#define PACKED_NORMALS\n";
+    }
+
+    // Build into temporaries so a failed reload keeps the working set
+    Shader render, normals, lighting, cascade, temporalResolve, composite, fusedComposite;
+    Shader overlayComposite, fusedOverlayComposite;
+    // Lighting and temporal resolve keep 16x16 workgroups: each one is a temporal tile
+    std::string renderHeader = header + workgroupDefines(workgroups[static_cast<int>(Kernel::Render)]);
+    std::string cascadeHeader = header + workgroupDefines(workgroups[static_cast<int>(Kernel::Cascades)]);
+    std::string compositeHeader = header + workgroupDefines(workgroups[static_cast<int>(Kernel::Composite)]);
+    if (!render.loadCompute("shaders/render.comp", renderHeader)) {
+        std::cerr << "Failed to load render shader" << std::endl;
+        return false;
+    }
+    if (!normals.loadCompute("shaders/render.comp", renderHeader + "#define NORMALS_ONLY\n")) {
+        std::cerr << "Failed to load normal shader" << std::endl;
+        return false;
+    }
+    if (!lighting.loadCompute("shaders/lighting.comp", header)) {
+        std::cerr << "Failed to load lighting shader" << std::endl;
+        return false;
+    }
+    if (!cascade.loadCompute("shaders/radiance_cascades.comp", cascadeHeader)) {
+        std::cerr << "Failed to load radiance cascades shader" << std::endl;
+        return false;
+    }
+    if (!temporalResolve.loadCompute("shaders/temporal_resolve.comp", header)) {
+        std::cerr << "Failed to load temporal resolve shader" << std::endl;
+        return false;
+    }
+    if (!composite.loadCompute("shaders/composite.comp", compositeHeader)) {
+        std::cerr << "Failed to load composite shader" << std::endl;
+        return false;
+    }
+    if (!fusedComposite.loadCompute("shaders/composite.comp", compositeHeader + "#define FUSED_COMPOSITE\n")) {
+        std::cerr << "Failed to load fused composite shader" << std::endl;
+        return false;
+    }
+    if (!overlayComposite.loadCompute("shaders/composite.comp", compositeHeader + "#define ACTIVITY_OVERLAY\n") ||
+        !fusedOverlayComposite.loadCompute("shaders/composite.comp",
+                                           compositeHeader + "#define FUSED_COMPOSITE\n#define ACTIVITY_OVERLAY\n")) {
+        std::cerr << "Failed to load activity overlay composite shaders" << std::endl;
+        return false;
+    }
+
+    renderShader = std::move(render);
+    normalShader = std::move(normals);
+    lightingShader = std::move(lighting);
+    cascadeShader = std::move(cascade);
+    temporalResolveShader = std::move(temporalResolve);
+    compositeShader = std::move(composite);
+    fusedCompositeShader = std::move(fusedComposite);
+    overlayCompositeShader = std::move(overlayComposite);
+    fusedOverlayCompositeShader = std::move(fusedOverlayComposite);
+    return true;
+}
+
+void World::applyRenderFormats() {
+    GLenum lightmap = renderSettingsData.compactLightmaps ? GL_R11F_G11F_B10F : GL_RGBA16F;
+    GLenum normal = renderSettingsData.packedNormals ? GL_RGBA8 : GL_RGBA16F;
+    GLenum display = renderSettingsData.compactDisplay ? GL_RGB10_A2 : GL_RGBA8;
+    if (lightmap == lightmapFormat && normal == normalFormat && display == displayFormat) return;
+
+    GLenum oldLightmap = lightmapFormat;
+    GLenum oldNormal = normalFormat;
+    GLenum oldDisplay = displayFormat;
+    lightmapFormat = lightmap;
+    normalFormat = normal;
+    displayFormat = display;
+
+    if (!loadFormatShaders()) {
+        std::cerr << "Keeping previous render target formats" << std::endl;
+        lightmapFormat = oldLightmap;
+        normalFormat = oldNormal;
+        displayFormat = oldDisplay;
+        renderSettingsData.compactLightmaps = (oldLightmap == GL_R11F_G11F_B10F);
+        renderSettingsData.packedNormals = (oldNormal == GL_RGBA8);
+        renderSettingsData.compactDisplay = (oldDisplay == GL_RGB10_A2);
+        return;
+    }
+
+    if (lightmap != oldLightmap) {
+        createLightmaps(lightingDownsample);
+    }
+    if (normal != oldNormal && normalTexture) {
+        // Reallocated in the new format by updateRenderTargets()
+        glDeleteTextures(1, &normalTexture);
+        normalTexture = 0;
+    }
+    if (display != oldDisplay) {
+        createDisplayTexture();
+    }
+}
+
+MemoryUsage World::memoryUsage() const {
+    return computeMemoryUsage(lightmapFormat, normalFormat, displayFormat);
+}
+
+MemoryUsage World::uncompactedMemoryUsage() const {
+    return computeMemoryUsage(GL_RGBA16F, GL_RGBA16F, GL_RGBA8);
+}
+
+MemoryUsage World::computeMemoryUsage(GLenum lightmap, GLenum normal, GLenum display) const {
+    size_t worldPixels = static_cast<size_t>(worldWidth) * worldHeight;
+    size_t lightmapPixels = static_cast<size_t>(lightmapWidth) * lightmapHeight;
+
+    MemoryUsage usage;
+    usage.state = (threaded ? 5 : 2) * worldPixels * 4;
+    usage.renderTargets = (colorTexture ? worldPixels * 4 : 0) + (normalTexture ? worldPixels * bytesPerTexel(normal) : 0);
+    usage.lightmaps = (lightmapPingPong ? 3 : 2) * lightmapPixels * bytesPerTexel(lightmap);
+    // Overview mips shrink by 4x per level
+    size_t overview = 0;
+    for (int level = 0; level < overviewLevels; level++) {
+        overview += static_cast<size_t>(overviewWidth >> level) * (overviewHeight >> level) * 4;
+    }
+    usage.display = worldPixels * bytesPerTexel(display)
+                  + overview
+                  + static_cast<size_t>(minimapWidth) * minimapHeight * 4;
+
+    // Occupancy mips shrink by 4x per level
+    size_t occupancy = 0;
+    for (int level = 0; level < occupancyLevels; level++) {
+        occupancy += static_cast<size_t>(occupancyWidth >> level) * (occupancyHeight >> level) * 4;
+    }
+    usage.lighting = occupancy
+                   + static_cast<size_t>(SHADOW_MAP_RESOLUTION) * MAX_SHADOW_LIGHTS * 4
+                   + 4 * sizeof(int) + static_cast<size_t>(MAX_SHADOW_LIGHTS + MAX_LIGHT_CANDIDATES) * SHADOW_LIGHT_STRIDE
+                   + static_cast<size_t>(temporalTilesX) * temporalTilesY * 2 * sizeof(uint32_t);
+    usage.transient = frameGraph.stats().pooledBytes;
+    return usage;
+}
+
 void World::createTextures() {
     // Create state textures (RGBA8UI)
     glGenTextures(2, stateTextures);
@@ -77,51 +511,269 @@ void World::createTextures() {
             GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, clearData.data());
     }
 
-    // Create color texture (RGBA8)
-    glGenTextures(1, &colorTexture);
-    glBindTexture(GL_TEXTURE_2D, colorTexture);
-    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, worldWidth, worldHeight);
+    // Color and normal textures are created on demand by updateRenderTargets()
+
+    // Create lightmap textures
+    createLightmaps(1);
+
+    // Create display texture
+    createDisplayTexture();
+
+    // Radiance cascade size (frame graph transients, RGBA16F: rgb = merged radiance)
+    // Top cascade spaces probes 2^MAX_CASCADES apart, so pad to a multiple of that
+    int cascadeAlign = 1 << MAX_CASCADES;
+    cascadeWidth = (worldWidth + cascadeAlign - 1) / cascadeAlign * cascadeAlign;
+    cascadeHeight = (worldHeight + cascadeAlign - 1) / cascadeAlign * cascadeAlign;
+
+    // Create occupancy pyramid (RG16F: r = max opacity, g = min opacity)
+    // Levels stop once a texel would span the whole world
+    occupancyLevels = 1;
+    while (occupancyLevels < MAX_OCCUPANCY_LEVELS &&
+           (1 << occupancyLevels) < std::max(worldWidth, worldHeight)) {
+        occupancyLevels++;
+    }
+    int occupancyAlign = 1 << (occupancyLevels - 1);
+    occupancyWidth = (worldWidth + occupancyAlign - 1) / occupancyAlign * occupancyAlign;
+    occupancyHeight = (worldHeight + occupancyAlign - 1) / occupancyAlign * occupancyAlign;
+
+    glGenTextures(1, &occupancyTexture);
+    glBindTexture(GL_TEXTURE_2D, occupancyTexture);
+    glTexStorage2D(GL_TEXTURE_2D, occupancyLevels, GL_RG16F, occupancyWidth, occupancyHeight);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    // Create overview pyramid (RGBA8UI: majority element per 2^L x 2^L block)
+    // Level L is mip L - 1, padded so each mip is exactly half the one below
+    overviewLevels = 1;
+    while (overviewLevels < MAX_OVERVIEW_LEVELS &&
+           (2 << overviewLevels) <= std::max(worldWidth, worldHeight)) {
+        overviewLevels++;
+    }
+    int overviewAlign = 1 << overviewLevels;
+    overviewWidth = (worldWidth + overviewAlign - 1) / overviewAlign * overviewAlign / 2;
+    overviewHeight = (worldHeight + overviewAlign - 1) / overviewAlign * overviewAlign / 2;
+
+    glGenTextures(1, &overviewTexture);
+    glBindTexture(GL_TEXTURE_2D, overviewTexture);
+    glTexStorage2D(GL_TEXTURE_2D, overviewLevels, GL_RGBA8UI, overviewWidth, overviewHeight);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    // Minimap (RGBA8), MINIMAP_SIZE along the world's longer side,
+    // read from the coarsest level that still has a cell per minimap texel
+    int longSide = std::max(worldWidth, worldHeight);
+    minimapWidth = std::max(worldWidth * MINIMAP_SIZE / longSide, 1);
+    minimapHeight = std::max(worldHeight * MINIMAP_SIZE / longSide, 1);
+    minimapLevel = 1;
+    while (minimapLevel < overviewLevels && (longSide >> (minimapLevel + 1)) >= MINIMAP_SIZE) {
+        minimapLevel++;
+    }
+
+    glGenTextures(1, &minimapTexture);
+    glBindTexture(GL_TEXTURE_2D, minimapTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, minimapWidth, minimapHeight);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-    // Create normal texture (RGBA16F: xy = normal, z = height, w = specular power)
-    glGenTextures(1, &normalTexture);
-    glBindTexture(GL_TEXTURE_2D, normalTexture);
-    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA16F, worldWidth, worldHeight);
+    // Create shadow map texture (R32F: x = angle bin, y = light)
+    glGenTextures(1, &shadowMapTexture);
+    glBindTexture(GL_TEXTURE_2D, shadowMapTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_R32F, SHADOW_MAP_RESOLUTION, MAX_SHADOW_LIGHTS);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Shadow light buffers: 4 ints of counts/padding, then the selected lights
+    glGenBuffers(1, &shadowLightBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, shadowLightBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, 4 * sizeof(int) + MAX_SHADOW_LIGHTS * SHADOW_LIGHT_STRIDE,
+        nullptr, GL_DYNAMIC_DRAW);
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32I, GL_RED_INTEGER, GL_INT, nullptr);
+
+    glGenBuffers(1, &lightCandidateBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, lightCandidateBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, MAX_LIGHT_CANDIDATES * SHADOW_LIGHT_STRIDE, nullptr, GL_DYNAMIC_DRAW);
+
+    // Dirty tile masks: one bit per tile, packed into uints
+    dirtyTilesX = (worldWidth + DIRTY_TILE_SIZE - 1) / DIRTY_TILE_SIZE;
+    dirtyTilesY = (worldHeight + DIRTY_TILE_SIZE - 1) / DIRTY_TILE_SIZE;
+    GLsizeiptr dirtyMaskSize = (dirtyTilesX * dirtyTilesY + 31) / 32 * sizeof(uint32_t);
+
+    glGenBuffers(1, &dirtyTileBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, dirtyTileBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, dirtyMaskSize, nullptr, GL_DYNAMIC_DRAW);
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+    glGenBuffers(1, &renderTileBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, renderTileBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, dirtyMaskSize, nullptr, GL_DYNAMIC_DRAW);
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+    // Activity counter (one uint, reset before each frame's steps)
+    glGenBuffers(1, &activityBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, activityBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+    // Activity heat map: changed cells per tile, folded into a tile-resolution texture
+    glGenBuffers(1, &tileChangeBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, tileChangeBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, dirtyTilesX * dirtyTilesY * sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+    glCreateTextures(GL_TEXTURE_2D, 1, &activityHeatTexture);
+    glTextureStorage2D(activityHeatTexture, 1, GL_RG16F, dirtyTilesX, dirtyTilesY);
+    glTextureParameteri(activityHeatTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTextureParameteri(activityHeatTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glClearTexImage(activityHeatTexture, 0, GL_RG, GL_FLOAT, nullptr);
+
+    // Instrumentation counters
+    glGenBuffers(1, &simCounterBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, simCounterBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, SIM_COUNTERS * sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+    // Element histogram (cleared before each count)
+    glGenBuffers(1, &populationBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, populationBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(ElementPopulation), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void World::updateRenderTargets(bool persistent, bool needColor, bool needNormals) {
+    // Without dirty-tile reuse nothing here outlives a frame; the frame graph supplies transients
+    if (!persistent) {
+        needColor = false;
+        needNormals = false;
+    }
+
+    // Color texture (RGBA8), only read by the split composite path
+    if (needColor && !colorTexture) {
+        glGenTextures(1, &colorTexture);
+        glBindTexture(GL_TEXTURE_2D, colorTexture);
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, worldWidth, worldHeight);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        displayValid = false;
+    } else if (!needColor && colorTexture) {
+        glDeleteTextures(1, &colorTexture);
+        colorTexture = 0;
+    }
+
+    // Normal texture (RGBA16F: xyz = normal, w = specular power, or RGBA8 packed, see packing.glsl)
+    // Needed by the split composite path and by bounce passes
+    if (needNormals && !normalTexture) {
+        glGenTextures(1, &normalTexture);
+        glBindTexture(GL_TEXTURE_2D, normalTexture);
+        glTexStorage2D(GL_TEXTURE_2D, 1, normalFormat, worldWidth, worldHeight);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        displayValid = false;
+    } else if (!needNormals && normalTexture) {
+        glDeleteTextures(1, &normalTexture);
+        normalTexture = 0;
+    }
+
+    // Lightmap ping-pong, same layout as the lightmap
+    if (persistent && !lightmapPingPong) {
+        glGenTextures(1, &lightmapPingPong);
+        glBindTexture(GL_TEXTURE_2D, lightmapPingPong);
+        glTexStorage2D(GL_TEXTURE_2D, 1, lightmapFormat, lightmapWidth, lightmapHeight);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glClearTexImage(lightmapPingPong, 0, GL_RGBA, GL_FLOAT, nullptr);
+        displayValid = false;
+    } else if (!persistent && lightmapPingPong) {
+        glDeleteTextures(1, &lightmapPingPong);
+        lightmapPingPong = 0;
+    }
+}
+
+bool World::persistentTargets() const {
+    // Dirty-tile frames redraw changed tiles over last frame's color, normals and lightmaps
+    const RenderSettings& settings = renderSettingsData;
+    return tracksDirtyTiles() && !settings.animatedEffects &&
+           settings.lightingModel == LightingModel::Bounce && !settings.temporalLighting &&
+           settings.activityOverlay == ActivityOverlay::Off;
+}
+
+void World::createDisplayTexture() {
+    if (displayTexture) glDeleteTextures(1, &displayTexture);
+
+    // Display texture (RGBA8, or RGB10_A2 for compactDisplay)
+    glGenTextures(1, &displayTexture);
+    glBindTexture(GL_TEXTURE_2D, displayTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, displayFormat, worldWidth, worldHeight);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Allocated at world size; dynamic resolution only shrinks the shaded region
+    setRenderScale(shownStats.renderScale);
+}
+
+void World::createLightmaps(int downsample) {
+    if (lightmapTexture) glDeleteTextures(1, &lightmapTexture);
+    if (lightmapPingPong) glDeleteTextures(1, &lightmapPingPong);
+    lightmapPingPong = 0; // Recreated at the new size by updateRenderTargets()
+    if (lightHistoryTexture) glDeleteTextures(1, &lightHistoryTexture);
+    if (temporalTileBuffer) glDeleteBuffers(1, &temporalTileBuffer);
+
+    lightingDownsample = downsample;
+    lightmapWidth = (worldWidth + downsample - 1) / downsample;
+    lightmapHeight = (worldHeight + downsample - 1) / downsample;
 
-    // Create lightmap textures (RGBA16F: rgb = light color, a = intensity)
+    // Lightmap texture (RGBA16F or R11F_G11F_B10F: rgb = light color)
     glGenTextures(1, &lightmapTexture);
     glBindTexture(GL_TEXTURE_2D, lightmapTexture);
-    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA16F, worldWidth, worldHeight);
+    glTexStorage2D(GL_TEXTURE_2D, 1, lightmapFormat, lightmapWidth, lightmapHeight);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-    glGenTextures(1, &lightmapPingPong);
-    glBindTexture(GL_TEXTURE_2D, lightmapPingPong);
-    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA16F, worldWidth, worldHeight);
+    // Temporal history, same layout as the lightmaps
+    glGenTextures(1, &lightHistoryTexture);
+    glBindTexture(GL_TEXTURE_2D, lightHistoryTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, lightmapFormat, lightmapWidth, lightmapHeight);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-    // Create display texture (RGBA8)
-    glGenTextures(1, &displayTexture);
-    glBindTexture(GL_TEXTURE_2D, displayTexture);
-    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, worldWidth, worldHeight);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    // Start from darkness rather than undefined contents
+    glClearTexImage(lightmapTexture, 0, GL_RGBA, GL_FLOAT, nullptr);
+    glClearTexImage(lightHistoryTexture, 0, GL_RGBA, GL_FLOAT, nullptr);
 
     glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Temporal tiles: 2 uints (signature, changed) per tile
+    temporalTilesX = (lightmapWidth + TEMPORAL_TILE_SIZE - 1) / TEMPORAL_TILE_SIZE;
+    temporalTilesY = (lightmapHeight + TEMPORAL_TILE_SIZE - 1) / TEMPORAL_TILE_SIZE;
+
+    glGenBuffers(1, &temporalTileBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, temporalTileBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, temporalTilesX * temporalTilesY * 2 * sizeof(uint32_t),
+        nullptr, GL_DYNAMIC_DRAW);
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    temporalHistoryValid = false;
+    displayValid = false;
 }
 
 void World::createQuad() {
@@ -160,120 +812,721 @@ void World::clear() {
             GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, clearData.data());
     }
     glBindTexture(GL_TEXTURE_2D, 0);
+
+    // The whole world changed outside the simulation (a threaded renderer redraws every handover)
+    if (!threaded) displayValid = false;
+    stateChanged = true;
+    wake();
+}
+
+void World::step(int steps) {
+    pollSimCounters();
+    for (int i = 0; i < steps; i++) {
+        simulationStep();
+        simulationTime += FIXED_TIMESTEP;
+    }
+    stats.stepsLastFrame = steps;
+    requestSimCounters(steps);
+    updateActivityHeat(steps, steps * FIXED_TIMESTEP);
+    publishState();
+}
+
+void World::readCells(int x, int y, int w, int h, std::vector<uint8_t>& cells) const {
+    // Steps and brushes write the state with imageStore
+    glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+    cells.resize(static_cast<size_t>(w) * h * 4);
+    glGetTextureSubImage(stateTextures[currentBuffer], 0, x, y, 0, w, h, 1,
+        GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, static_cast<GLsizei>(cells.size()), cells.data());
+}
+
+void World::countElements(ElementPopulation& counts) {
+    dispatchPopulation();
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glGetNamedBufferSubData(populationBuffer, 0, sizeof(ElementPopulation), counts.data());
+}
+
+void World::writeCells(int x, int y, int w, int h, const std::vector<uint8_t>& cells) {
+    if (cells.size() < static_cast<size_t>(w) * h * 4) return;
+
+    // Pending imageStores to the state must land before the upload replaces it
+    glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+    glTextureSubImage2D(stateTextures[currentBuffer], 0, x, y, w, h,
+        GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, cells.data());
+
+    // Changed outside the simulation, like clear()
+    if (!threaded) displayValid = false;
+    stateChanged = true;
+    wake();
+}
+
+void World::paint(int x, int y, int radius, int shape, uint32_t element, bool erase) {
+    wake();
+
+    brushShader.use();
+    brushShader.setInt("brushX", x);
+    brushShader.setInt("brushY", y);
+    brushShader.setInt("brushSize", radius);
+    brushShader.setInt("brushShape", shape);
+    brushShader.setUint("drawElement", element);
+    brushShader.setBool("isEraser", erase);
+    brushShader.setBool("trackDirty", tracksDirtyTiles());
+
+    // binding 0: current state (read/write), SSBO 6: dirty tiles
+    glBindImageTexture(0, stateTextures[currentBuffer], 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA8UI);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, dirtyTileBuffer);
+
+    // Dispatch enough groups to cover brush size
+    glDispatchCompute(workgroupCount(radius * 2 + 1, DEFAULT_WORKGROUP.x),
+                      workgroupCount(radius * 2 + 1, DEFAULT_WORKGROUP.y), 1);
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+    stateChanged = true;
 }
 
 void World::simulationStep() {
+    WorkgroupSize cellGroup = workgroup(Kernel::Simulation);
+    GLuint cellGroupsX = workgroupCount(worldWidth, cellGroup.x);
+    GLuint cellGroupsY = workgroupCount(worldHeight, cellGroup.y);
+
+    bool instrumented = instrumentedSteps();
+    if (simSettings.engine == SimulationEngine::Margolus) {
+        // One invocation per 2x2 block, with a spare block for the odd offset
+        WorkgroupSize blockGroup = workgroup(Kernel::Margolus);
+        GLuint blockGroupsX = workgroupCount(worldWidth / 2 + 1, blockGroup.x);
+        GLuint blockGroupsY = workgroupCount(worldHeight / 2 + 1, blockGroup.y);
+        // The first reaction pass of each frame is timed on its own, see SimulationStats::reactionMs
+        bool timed = timeReactionPass && reactionTimer.begin();
+        timeReactionPass = false;
+        simulationPass(instrumented ? instrumentedReactionShader : reactionShader, Kernel::Simulation, cellGroupsX, cellGroupsY);
+        if (timed) reactionTimer.end();
+        simulationPass(instrumented ? instrumentedMargolusShader : margolusShader, Kernel::Margolus, blockGroupsX, blockGroupsY);
+    } else {
+        simulationPass(instrumented ? instrumentedSimulationShader : simulationShader, Kernel::Simulation, cellGroupsX, cellGroupsY);
+    }
+
+    frameCount++;
+    stateChanged = true;
+}
+
+void World::simulationPass(const Shader& shader, Kernel kernel, GLuint groupsX, GLuint groupsY) {
     int nextBuffer = 1 - currentBuffer;
 
     // Bind textures to image units
     glBindImageTexture(0, stateTextures[currentBuffer], 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA8UI);
     glBindImageTexture(1, stateTextures[nextBuffer], 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8UI);
 
-    // Run simulation shader
-    simulationShader.use();
-    simulationShader.setVec2("worldSize", static_cast<float>(worldWidth), static_cast<float>(worldHeight));
-    simulationShader.setFloat("time", simulationTime);
-    simulationShader.setUint("frameCount", frameCount);
+    shader.use();
+    shader.setVec2("worldSize", static_cast<float>(worldWidth), static_cast<float>(worldHeight));
+    shader.setFloat("time", simulationTime);
+    shader.setUint("frameCount", frameCount);
+    shader.setBool("trackDirty", tracksDirtyTiles());
+    shader.setBool("countTiles", simSettings.tileActivity);
+
+    // SSBO 6: dirty tiles, OR-ed over every step until the next render
+    // SSBO 8: activity counter
+    // SSBO 11, 12: instrumentation counters and tile changes (instrumented variants only)
+    // SSBO 13: Margolus block rules (Margolus shader only)
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, dirtyTileBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 8, activityBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 11, simCounterBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 12, tileChangeBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 13, margolusRuleBuffer);
 
-    GLuint workGroupsX = (worldWidth + 15) / 16;
-    GLuint workGroupsY = (worldHeight + 15) / 16;
-    glDispatchCompute(workGroupsX, workGroupsY, 1);
+    dispatchKernel(kernel, groupsX, groupsY);
 
-    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
 
     swapBuffers();
-    frameCount++;
 }
 
 void World::update(float dt) {
+    pollActivity();
+    pollStepTimer();
+    pollSimCounters();
+    while (populationReadback.poll(stats.population.data())) {}
+
+    // Settled: no steps, and time stands still so the last rendered frame stays valid
+    if (idle) {
+        accumulatedTime = 0.0f;
+        stats.stepsLastFrame = 0;
+        updateActivityHeat(0, dt);
+        publishState();
+        return;
+    }
+
     accumulatedTime += dt;
     simulationTime += dt;
 
-    // Fixed timestep simulation
+    // Fixed timestep simulation, at most stepLimit() steps this frame
+    int limit = stepLimit();
+    int steps = 0;
+    bool fellBehind = false;
+    bool timed = false;
     while (accumulatedTime >= FIXED_TIMESTEP) {
+        if (limit > 0 && steps + simSettings.stepsPerFrame > limit) {
+            // Over budget: drop whole ticks rather than carry them into an already slow next frame
+            float dropped = std::floor(accumulatedTime / FIXED_TIMESTEP) * FIXED_TIMESTEP;
+            accumulatedTime -= dropped;
+            stats.debtSeconds += dropped;
+            fellBehind = true;
+            break;
+        }
+
+        if (steps == 0) {
+            if (simSettings.idleWhenSettled) {
+                glClearNamedBufferData(activityBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+            }
+            timed = stepTimer.begin();
+            timeReactionPass = true;
+        }
         for (int i = 0; i < simSettings.stepsPerFrame; i++) {
             simulationStep();
+            steps++;
         }
         accumulatedTime -= FIXED_TIMESTEP;
     }
+
+    if (timed) {
+        stepTimer.end();
+        timedStepCounts.push_back(steps);
+    }
+    stats.stepsLastFrame = steps;
+    updateLightingDegrade(fellBehind);
+
+    // Ask for this frame's activity; dropped if the readback ring is still busy
+    if (steps > 0 && simSettings.idleWhenSettled) {
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+        activityReadback.request(activityBuffer);
+    }
+    requestSimCounters(steps);
+    updateActivityHeat(steps, dt);
+
+    // Likewise this frame's population, counted from the state the steps left
+    if (steps > 0 && simSettings.populationStats) {
+        dispatchPopulation();
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+        populationReadback.request(populationBuffer);
+    }
+
+    publishState();
 }
 
-void World::render(int screenX, int screenY, int screenWidth, int screenHeight) {
-    GLuint workGroupsX = (worldWidth + 15) / 16;
-    GLuint workGroupsY = (worldHeight + 15) / 16;
+// Exponential averages so one hitch does not swing the step limit
+constexpr float TIMER_SMOOTHING = 0.2f;
 
-    // Pass 1: Convert state texture to colors
-    // binding 0: stateIn (RGBA8UI, read)
-    // binding 1: colorOut (RGBA8, write)
-    // binding 2: normalOut (RGBA16F, write)
-    glBindImageTexture(0, stateTextures[currentBuffer], 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA8UI);
-    glBindImageTexture(1, colorTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
-    glBindImageTexture(2, normalTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
-
-    renderShader.use();
-    renderShader.setVec4("backgroundColor",
-        renderSettingsData.backgroundColor.r,
-        renderSettingsData.backgroundColor.g,
-        renderSettingsData.backgroundColor.b,
-        renderSettingsData.backgroundColor.a);
-    renderShader.setFloat("time", simulationTime);
-
-    glDispatchCompute(workGroupsX, workGroupsY, 1);
-    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
-
-    // Pass 2: Light Propagation
-    lightingShader.use();
-    lightingShader.setBool("glowEnabled", renderSettingsData.glowEnabled);
-    lightingShader.setFloat("glowIntensity", renderSettingsData.glowIntensity);
-    lightingShader.setFloat("glowRadius", renderSettingsData.glowRadius);
-    lightingShader.setFloat("time", simulationTime);
-    lightingShader.setFloat("ambientLight", renderSettingsData.ambientLight);
-
-    int bounces = renderSettingsData.lightBounces;
-    for (int bounce = 0; bounce < bounces; bounce++) {
-        // Read from state + normals, ping-pong lightmaps
-        GLuint readLight  = (bounce == 0) ? lightmapTexture : ((bounce % 2 == 0) ? lightmapTexture : lightmapPingPong);
-        GLuint writeLight = (bounce % 2 == 0) ? lightmapPingPong : lightmapTexture;
+void World::pollStepTimer() {
+    double ms = 0.0;
+    while (!timedStepCounts.empty() && stepTimer.poll(ms)) {
+        float perStep = static_cast<float>(ms) / static_cast<float>(std::max(timedStepCounts.front(), 1));
+        stats.timedStepMs += ms;
+        stats.timedSteps += timedStepCounts.front();
+        stats.stepMs = (stats.stepMs > 0.0f) ? stats.stepMs + (perStep - stats.stepMs) * TIMER_SMOOTHING : perStep;
+        timedStepCounts.pop_front();
+    }
+    while (reactionTimer.poll(ms)) {
+        stats.reactionMs = (stats.reactionMs > 0.0f)
+            ? stats.reactionMs + (static_cast<float>(ms) - stats.reactionMs) * TIMER_SMOOTHING
+            : static_cast<float>(ms);
+        stats.timedReactionMs += ms;
+        stats.timedReactionPasses++;
+    }
+    stats.stepLimit = stepLimit();
+}
 
-        // binding 0: stateIn
-        // binding 1: normalIn
-        // binding 3: lightIn (read from previous bounce, or empty on first)
-        // binding 4: lightOut (write)
-        glBindImageTexture(0, stateTextures[currentBuffer], 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA8UI);
-        glBindImageTexture(1, normalTexture, 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA16F);
-        glBindImageTexture(3, readLight, 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA16F);
-        glBindImageTexture(4, writeLight, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+void World::requestSimCounters(int steps) {
+    if (steps == 0 || !instrumentedSteps()) return;
+
+    // Read back this frame's counts, dropped if the ring is still busy, then start afresh
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    if (simSettings.instrumentation && simCounterReadback.request(simCounterBuffer)) {
+        countedStepCounts.push_back(steps);
+    }
+    glClearNamedBufferData(simCounterBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+}
+
+bool World::instrumentedSteps() const {
+    return simSettings.instrumentation || simSettings.tileActivity;
+}
 
-        lightingShader.setInt("bouncePass", bounce);
+void World::updateActivityHeat(int steps, float dt) {
+    if (!simSettings.tileActivity) return;
 
-        glDispatchCompute(workGroupsX, workGroupsY, 1);
-        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    // Frames between steps have nothing new to fold; their time decays at the next fold
+    heatElapsed += dt;
+    if (steps > 0) {
+        heatQuietTime = 0.0f;
+    } else {
+        // Settled: keep fading the peaks at most once per tick until they are gone
+        if (!idle || heatQuietTime >= HEAT_FADE_TIME || heatElapsed < FIXED_TIMESTEP) return;
+        heatQuietTime += heatElapsed;
     }
 
-    // Determine which lightmap has the final result
-    GLuint finalLightmap = (bounces % 2 == 0) ? lightmapTexture : lightmapPingPong;
-    // If bounces == 0, we never ran the loop, use lightmapTexture as empty fallback
-    if (bounces == 0) finalLightmap = lightmapTexture;
+    // binding 0: heat (read/write), SSBO 12: tile changes (read, cleared)
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    glBindImageTexture(0, activityHeatTexture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RG16F);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 12, tileChangeBuffer);
 
-    // Pass 3: Composite
-    // binding 0: stateIn
-    // binding 1: colorIn
-    // binding 2: normalIn
-    // binding 3: lightmapIn
-    // binding 4: displayOut
+    activityHeatShader.use();
+    activityHeatShader.setIVec2("worldSize", worldWidth, worldHeight);
+    activityHeatShader.setInt("steps", steps);
+    activityHeatShader.setFloat("decay", std::exp2(-heatElapsed / HEAT_HALF_LIFE));
+    glDispatchCompute(workgroupCount(dirtyTilesX, DEFAULT_WORKGROUP.x), workgroupCount(dirtyTilesY, DEFAULT_WORKGROUP.y), 1);
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+    heatElapsed = 0.0f;
+
+    // A settled world must still hand over (threaded) or redraw (unthreaded) the fading heat
+    stateChanged = true;
+    heatFolded = !threaded;
+}
+
+void World::pollSimCounters() {
+    std::array<uint32_t, SIM_COUNTERS> counts;
+    while (!countedStepCounts.empty() && simCounterReadback.poll(counts.data())) {
+        float steps = static_cast<float>(countedStepCounts.front());
+        for (int i = 0; i < SIM_COUNTERS; i++) {
+            float perStep = static_cast<float>(counts[i]) / steps;
+            stats.eventsPerStep[i] += (perStep - stats.eventsPerStep[i]) * TIMER_SMOOTHING;
+            stats.countedEvents[i] += counts[i];
+        }
+        stats.countedSteps += countedStepCounts.front();
+        countedStepCounts.pop_front();
+    }
+    if (!simSettings.instrumentation) stats.eventsPerStep.fill(0.0f);
+}
+
+void World::pollRenderTimer() {
+    double ms = 0.0;
+    while (renderTimer.poll(ms)) {
+        shownStats.renderMs += (static_cast<float>(ms) - shownStats.renderMs) * TIMER_SMOOTHING;
+    }
+    governorRenderMs.store(shownStats.renderMs, std::memory_order_relaxed);
+}
+
+int World::stepLimit() const {
+    if (!simSettings.stepGovernor || stats.stepMs <= 0.0f) return 0;
+
+    // Whatever the render passes leave of the budget, but always at least one tick
+    float available = simSettings.frameBudgetMs - governorRenderMs.load(std::memory_order_relaxed);
+    int steps = static_cast<int>(available / stats.stepMs);
+    return std::max(steps, simSettings.stepsPerFrame);
+}
+
+void World::updateLightingDegrade(bool fellBehind) {
+    // Step down after a run of slow frames, back up only after a long calm stretch
+    constexpr int DEGRADE_AFTER = 10;
+    constexpr int RESTORE_AFTER = 120;
+
+    int level = stats.lightingDegrade;
+    if (!simSettings.stepGovernor || !simSettings.degradeLighting) {
+        level = 0;
+    } else if (fellBehind) {
+        caughtUpFrames = 0;
+        if (++behindFrames >= DEGRADE_AFTER) {
+            level = std::min(level + 1, MAX_LIGHTING_DEGRADE);
+            behindFrames = 0;
+        }
+    } else {
+        behindFrames = 0;
+        if (++caughtUpFrames >= RESTORE_AFTER) {
+            level = std::max(level - 1, 0);
+            caughtUpFrames = 0;
+        }
+    }
+
+    // render() invalidates its frame when the new level reaches it through showStats()
+    stats.lightingDegrade = level;
+}
+
+void World::updateRenderScale() {
+    // Timer results trail a rescale by a few frames; wait for ones taken at the new scale
+    constexpr int SETTLE_FRAMES = 8;
+    constexpr float SCALE_STEP = 1.0f / 16.0f;
+
+    const RenderSettings& settings = renderSettingsData;
+    if (!settings.dynamicResolution) {
+        if (shownStats.renderScale != 1.0f) setRenderScale(1.0f);
+        return;
+    }
+    if (++framesSinceRescale < SETTLE_FRAMES || shownStats.renderMs <= 0.0f) return;
+
+    // Shading cost goes with pixel count, so scale by the square root of the budget ratio
+    float simulationMs = shownStats.stepMs * static_cast<float>(shownStats.stepsLastFrame);
+    float budget = std::max(settings.targetFrameMs - simulationMs, 1.0f);
+    float target = shownStats.renderScale * std::sqrt(budget / shownStats.renderMs);
+
+    float minScale = std::clamp(settings.minRenderScale, 0.25f, 1.0f);
+    target = std::clamp(std::round(target / SCALE_STEP) * SCALE_STEP, minScale, 1.0f);
+    if (target != shownStats.renderScale) {
+        setRenderScale(target);
+    }
+}
+
+void World::setRenderScale(float scale) {
+    shownStats.renderScale = scale;
+    framesSinceRescale = 0;
+    updateRenderSize();
+}
+
+void World::updateOverviewLevel(const WorldView& view, int screenWidth) {
+    // Step down a pyramid level each time a screen pixel covers twice as many cells.
+    // Overview levels stand in for the state, which only the fused composite reads directly.
+    int level = 0;
+    if (renderSettingsData.overviewRendering && renderSettingsData.fusedComposite && screenWidth > 0) {
+        float viewWidth = (view.width > 0.0f) ? view.width : static_cast<float>(worldWidth);
+        float cellsPerPixel = viewWidth / static_cast<float>(screenWidth);
+        while (level < overviewLevels && cellsPerPixel >= static_cast<float>(2 << level)) {
+            level++;
+        }
+    }
+
+    if (level != overviewLevel) {
+        overviewLevel = level;
+        updateRenderSize();
+    }
+}
+
+float World::compositeScale() const {
+    return shownStats.renderScale / static_cast<float>(1 << overviewLevel);
+}
+
+void World::updateRenderSize() {
+    float scale = compositeScale();
+    renderWidth = std::max(static_cast<int>(std::ceil(static_cast<float>(worldWidth) * scale)), 1);
+    renderHeight = std::max(static_cast<int>(std::ceil(static_cast<float>(worldHeight) * scale)), 1);
+    displayValid = false;
+
+    // Pixel-exact at full scale, filtered when stretching a smaller image
+    GLint filter = (scale < 1.0f) ? GL_LINEAR : GL_NEAREST;
+    glTextureParameteri(displayTexture, GL_TEXTURE_MIN_FILTER, filter);
+    glTextureParameteri(displayTexture, GL_TEXTURE_MAG_FILTER, filter);
+}
+
+void World::buildOverview(int levels) {
+    // binding 1: levelIn (state or level - 1)
+    // binding 2: levelOut (level), pyramid level L lives in mip L - 1
+    for (int level = 1; level <= levels; level++) {
+        auto pass = frameGraph.addPass("overview");
+        if (level == 1) {
+            pass.read(1, targets.state, GL_RGBA8UI);
+        } else {
+            pass.read(1, targets.overview, GL_RGBA8UI, level - 2);
+        }
+        pass.write(2, targets.overview, GL_RGBA8UI, level - 1);
+
+        int levelWidth = overviewWidth >> (level - 1);
+        int levelHeight = overviewHeight >> (level - 1);
+        pass.execute([this, levelWidth, levelHeight] {
+            stateDownsampleShader.use();
+            glDispatchCompute(workgroupCount(levelWidth, DEFAULT_WORKGROUP.x), workgroupCount(levelHeight, DEFAULT_WORKGROUP.y), 1);
+        });
+    }
+}
+
+void World::renderMinimap() {
+    // binding 0: levelIn, binding 1: minimapOut (sampled by the UI)
+    frameGraph.addPass("minimap")
+        .read(0, targets.overview, GL_RGBA8UI, minimapLevel - 1)
+        .write(1, targets.minimap, GL_RGBA8)
+        .execute([this] {
+            minimapShader.use();
+            minimapShader.setVec4("backgroundColor",
+                renderSettingsData.backgroundColor.r,
+                renderSettingsData.backgroundColor.g,
+                renderSettingsData.backgroundColor.b,
+                renderSettingsData.backgroundColor.a);
+            float levelCells = static_cast<float>(1 << minimapLevel);
+            minimapShader.setVec2("cellsPerTexel",
+                static_cast<float>(worldWidth) / levelCells / static_cast<float>(minimapWidth),
+                static_cast<float>(worldHeight) / levelCells / static_cast<float>(minimapHeight));
+
+            glDispatchCompute(workgroupCount(minimapWidth, DEFAULT_WORKGROUP.x), workgroupCount(minimapHeight, DEFAULT_WORKGROUP.y), 1);
+        });
+}
+
+void World::updateCulling(const WorldView& view) {
+    CellRect visible{0, 0, worldWidth, worldHeight};
+    if (view.width > 0.0f && view.height > 0.0f) {
+        visible.x0 = std::clamp(static_cast<int>(std::floor(view.x)), 0, worldWidth);
+        visible.y0 = std::clamp(static_cast<int>(std::floor(view.y)), 0, worldHeight);
+        visible.x1 = std::clamp(static_cast<int>(std::ceil(view.x + view.width)), 0, worldWidth);
+        visible.y1 = std::clamp(static_cast<int>(std::ceil(view.y + view.height)), 0, worldHeight);
+    }
+
+    // Light reaching the visible cells can come from, and bounce through, this far outside
+    int margin = static_cast<int>(std::ceil(lightReach()));
+    CellRect lit{
+        std::max(visible.x0 - margin, 0),
+        std::max(visible.y0 - margin, 0),
+        std::min(visible.x1 + margin, worldWidth),
+        std::min(visible.y1 + margin, worldHeight)};
+
+    // Newly exposed cells were never drawn; the whole view has to be rebuilt
+    if (visible != visibleCells || lit != litCells) {
+        displayValid = false;
+    }
+    visibleCells = visible;
+    litCells = lit;
+}
+
+void World::dispatchRegion(const Shader& shader, WorkgroupSize size, int x0, int y0, int x1, int y1) const {
+    // Origins stay on the workgroup grid so dirty-tile and workgroup math is unchanged
+    x0 -= x0 % size.x;
+    y0 -= y0 % size.y;
+    if (x1 <= x0 || y1 <= y0) return;
+
+    shader.setIVec2("dispatchOrigin", x0, y0);
+    glDispatchCompute(workgroupCount(x1 - x0, size.x), workgroupCount(y1 - y0, size.y), 1);
+}
+
+void World::dispatchRegion(const Shader& shader, Kernel kernel, int x0, int y0, int x1, int y1) {
+    bool timed = beginKernelSpan(kernel);
+    dispatchRegion(shader, workgroup(kernel), x0, y0, x1, y1);
+    if (timed) kernelTimer.end();
+}
+
+void World::dispatchKernel(Kernel kernel, GLuint groupsX, GLuint groupsY) {
+    bool timed = beginKernelSpan(kernel);
+    glDispatchCompute(groupsX, groupsY, 1);
+    if (timed) kernelTimer.end();
+}
+
+bool World::beginKernelSpan(Kernel kernel) {
+    if (timedKernel != static_cast<int>(kernel)) return false;
+
+    // Fold in finished spans so a long run keeps room in the ring
+    double ms = 0.0;
+    while (kernelTimer.poll(ms)) kernelMs += ms;
+
+    if (!kernelTimer.begin()) {
+        kernelSpanDropped = true;
+        return false;
+    }
+    kernelSpans++;
+    return true;
+}
+
+void World::beginKernelTiming(Kernel kernel) {
+    kernelTimer.init(KERNEL_TIMER_DEPTH);
+    timedKernel = static_cast<int>(kernel);
+    kernelSpans = 0;
+    kernelMs = 0.0;
+    kernelSpanDropped = false;
+}
+
+double World::endKernelTiming() {
+    timedKernel = -1;
+    glFinish();
+
+    double ms = 0.0;
+    while (kernelTimer.poll(ms)) kernelMs += ms;
+    kernelTimer.release();
+    if (kernelSpans == 0 || kernelSpanDropped) return -1.0;
+    return kernelMs;
+}
+
+int World::bounceCount() const {
+    if (shownStats.lightingDegrade == 0) return renderSettingsData.lightBounces;
+    return std::max(renderSettingsData.lightBounces - shownStats.lightingDegrade, 1);
+}
+
+void World::pollActivity() {
+    uint32_t activity = 0;
+    while (activityReadback.poll(&activity)) {
+        quietReadbacks = (activity == 0) ? quietReadbacks + 1 : 0;
+    }
+
+    if (simSettings.idleWhenSettled && quietReadbacks >= simSettings.settleFrames) {
+        idle.store(true, std::memory_order_relaxed);
+    } else if (!simSettings.idleWhenSettled) {
+        idle.store(false, std::memory_order_relaxed);
+    }
+}
+
+void World::dispatchPopulation() {
+    glClearNamedBufferData(populationBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+    populationShader.use();
     glBindImageTexture(0, stateTextures[currentBuffer], 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA8UI);
-    glBindImageTexture(1, colorTexture, 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA8);
-    glBindImageTexture(2, normalTexture, 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA16F);
-    glBindImageTexture(3, finalLightmap, 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA16F);
-    glBindImageTexture(4, displayTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 10, populationBuffer);
+    WorkgroupSize size = workgroup(Kernel::Population);
+    dispatchKernel(Kernel::Population, workgroupCount(worldWidth, size.x), workgroupCount(worldHeight, size.y));
+}
+
+void World::wake() {
+    idle.store(false, std::memory_order_relaxed);
+    quietReadbacks = 0;
+}
+
+void World::setThreaded(bool enabled) {
+    if (enabled && !published[0].texture) {
+        for (PublishedState& slot : published) {
+            glGenTextures(1, &slot.texture);
+            glBindTexture(GL_TEXTURE_2D, slot.texture);
+            glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8UI, worldWidth, worldHeight);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+            glCreateTextures(GL_TEXTURE_2D, 1, &slot.heat);
+            glTextureStorage2D(slot.heat, 1, GL_RG16F, dirtyTilesX, dirtyTilesY);
+            glTextureParameteri(slot.heat, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTextureParameteri(slot.heat, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
 
-    compositeShader.use();
-    compositeShader.setFloat("ambientLight", renderSettingsData.ambientLight);
-    compositeShader.setFloat("specularStrength", renderSettingsData.specularStrength);
-    compositeShader.setFloat("time", simulationTime);
+    if (enabled) {
+        // Every slot starts as the current state, so the first frames draw what is there
+        for (PublishedState& slot : published) {
+            glCopyImageSubData(stateTextures[currentBuffer], GL_TEXTURE_2D, 0, 0, 0, 0,
+                               slot.texture, GL_TEXTURE_2D, 0, 0, 0, 0, worldWidth, worldHeight, 1);
+            glCopyImageSubData(activityHeatTexture, GL_TEXTURE_2D, 0, 0, 0, 0,
+                               slot.heat, GL_TEXTURE_2D, 0, 0, 0, 0, dirtyTilesX, dirtyTilesY, 1);
+            slot.time = simulationTime;
+            slot.stats = stats;
+        }
+        glFinish();
+    }
+
+    threaded = enabled;
+    stateChanged = false;
+    displayValid = false;
+}
+
+void World::attachSimulationContext() {
+    stepTimer.init();
+    reactionTimer.init();
+    timedStepCounts.clear();
+}
+
+void World::releaseSimulationContext() {
+    stepTimer.release();
+    reactionTimer.release();
+    timedStepCounts.clear();
+}
 
-    glDispatchCompute(workGroupsX, workGroupsY, 1);
-    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+bool World::tracksDirtyTiles() const {
+    // The renderer clears the mask while the simulation thread sets bits, so a threaded
+    // world redraws everything on each handover instead
+    return !threaded && renderSettingsData.dirtyTracking;
+}
+
+GLuint World::renderState() const {
+    return threaded ? published[publishFront].texture : stateTextures[currentBuffer];
+}
+
+GLuint World::renderHeat() const {
+    // The simulation thread folds into activityHeatTexture while the renderer draws
+    return threaded ? published[publishFront].heat : activityHeatTexture;
+}
+
+void World::publishState() {
+    if (!threaded) {
+        showStats(stats, simulationTime, inputTime);
+        return;
+    }
+    if (!stateChanged) return;
+
+    // The renderer may still be drawing from the back slot's last handover
+    PublishedState& slot = published[publishBack];
+    if (slot.read) glWaitSync(slot.read, 0, GL_TIMEOUT_IGNORED);
+
+    glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT); // Image stores land before the copies
+    glCopyImageSubData(stateTextures[currentBuffer], GL_TEXTURE_2D, 0, 0, 0, 0,
+                       slot.texture, GL_TEXTURE_2D, 0, 0, 0, 0, worldWidth, worldHeight, 1);
+    glCopyImageSubData(activityHeatTexture, GL_TEXTURE_2D, 0, 0, 0, 0,
+                       slot.heat, GL_TEXTURE_2D, 0, 0, 0, 0, dirtyTilesX, dirtyTilesY, 1);
+    if (slot.written) glDeleteSync(slot.written);
+    slot.written = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush(); // Fences must reach the GPU before another context can wait on them
+    slot.time = simulationTime;
+    slot.inputTime = inputTime;
+    slot.stats = stats;
+
+    publishBack = publishMiddle.exchange(publishBack | FRESH_SLOT, std::memory_order_acq_rel) & ~FRESH_SLOT;
+    stateChanged = false;
+}
+
+bool World::acquireState() {
+    if (!(publishMiddle.load(std::memory_order_acquire) & FRESH_SLOT)) return false;
+
+    publishFront = publishMiddle.exchange(publishFront, std::memory_order_acq_rel) & ~FRESH_SLOT;
+    const PublishedState& slot = published[publishFront];
+    glWaitSync(slot.written, 0, GL_TIMEOUT_IGNORED);
+    showStats(slot.stats, slot.time, slot.inputTime);
+    return true;
+}
+
+void World::releaseState() {
+    if (!threaded) return;
+
+    PublishedState& slot = published[publishFront];
+    if (slot.read) glDeleteSync(slot.read);
+    slot.read = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+}
+
+void World::showStats(const SimulationStats& source, float time, double input) {
+    if (source.lightingDegrade != shownStats.lightingDegrade) {
+        displayValid = false;
+        temporalHistoryValid = false;
+    }
+
+    // Render timings belong to render()
+    float renderMs = shownStats.renderMs;
+    float renderScale = shownStats.renderScale;
+    shownStats = source;
+    shownStats.renderMs = renderMs;
+    shownStats.renderScale = renderScale;
+    shownTime = time;
+    shownInputTime = input;
+}
+
+void World::render(int screenX, int screenY, int screenWidth, int screenHeight, const WorldView& view) {
+    applyRenderFormats();
+    pollRenderTimer();
+
+    // Threaded: nothing moved unless the simulation handed over a new state
+    bool unchanged = threaded ? !acquireState()
+                              : idle.load(std::memory_order_relaxed) && !std::exchange(heatFolded, false);
+
+    // Lightmaps follow lightingScale: 1 -> full, 1/2 -> 2x2 cells per texel, 1/4 -> 4x4,
+    // coarsened further by the governor's lighting degrade level
+    int downsample = (renderSettingsData.lightingScale <= 0.25f) ? 4
+                   : (renderSettingsData.lightingScale <= 0.5f) ? 2 : 1;
+    downsample = std::min(downsample << shownStats.lightingDegrade, 4);
+
+    // Once a display texel spans 2+ cells (dynamic resolution or overview), finer light is wasted
+    updateRenderScale();
+    updateOverviewLevel(view, screenWidth);
+    float footprint = 1.0f / compositeScale();
+    if (footprint >= 2.0f) {
+        downsample = std::max(downsample, footprint >= 4.0f ? 4 : 2);
+    }
+    if (downsample != lightingDownsample) {
+        createLightmaps(downsample);
+    }
+    updateCulling(view);
+
+    // The fused composite evaluates color + normals itself, so pass 1 only runs for
+    // the split path or to give the bounce passes their normals.
+    bool fused = renderSettingsData.fusedComposite;
+    bool bounceNormals = renderSettingsData.lightingModel == LightingModel::Bounce &&
+                         bounceCount() > 1;
+    bool needNormals = !fused || bounceNormals;
+    updateRenderTargets(persistentTargets(), !fused, needNormals);
+
+    // Settled world: time is frozen and nothing moved, so the last frame is still exact
+    bool reuseFrame = unchanged && displayValid && !displayInputsChanged(displaySettings, renderSettingsData);
+    if (!reuseFrame) {
+        // Restrict passes 1-3 to dirty tiles when the previous frame can be reused
+        bool timed = renderTimer.begin();
+        // Dirty tiles are in world cells; overview levels redraw the visible area every frame
+        bool dirtyOnly = prepareDirtyTiles() && overviewLevel == 0;
+        renderFrame(fused, needNormals, dirtyOnly);
+        if (timed) renderTimer.end();
+        releaseState();
+    }
 
     // Pass 4: Blit display
     glViewport(screenX, screenY, screenWidth, screenHeight);
@@ -282,12 +1535,500 @@ void World::render(int screenX, int screenY, int screenWidth, int screenHeight)
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, displayTexture);
     quadShader.setInt("displayTex", 0);
+    quadShader.setVec2("uvScale", compositeScale(), compositeScale());
+    quadShader.setVec2("uvMax",
+        (static_cast<float>(renderWidth) - 0.5f) / static_cast<float>(worldWidth),
+        (static_cast<float>(renderHeight) - 0.5f) / static_cast<float>(worldHeight));
+
+    bool fullView = view.width <= 0.0f || view.height <= 0.0f;
+    quadShader.setVec2("viewOrigin",
+        fullView ? 0.0f : view.x / static_cast<float>(worldWidth),
+        fullView ? 0.0f : view.y / static_cast<float>(worldHeight));
+    quadShader.setVec2("viewSize",
+        fullView ? 1.0f : view.width / static_cast<float>(worldWidth),
+        fullView ? 1.0f : view.height / static_cast<float>(worldHeight));
 
     glBindVertexArray(quadVAO);
     glDrawArrays(GL_TRIANGLES, 0, 6);
     glBindVertexArray(0);
 }
 
+void World::renderFrame(bool fused, bool needNormals, bool dirtyOnly) {
+    declareFrameTargets(!fused, needNormals);
+
+    // Pass 1: Convert state texture to colors + normals
+    if (needNormals) {
+        // binding 0: stateIn (RGBA8UI, read)
+        // binding 1: colorOut (RGBA8, write, split path only)
+        // binding 2: normalOut (NORMAL_FORMAT, write)
+        auto pass = frameGraph.addPass("surface");
+        pass.read(0, targets.state, GL_RGBA8UI);
+        if (!fused) {
+            pass.write(1, targets.color, GL_RGBA8);
+        }
+        pass.write(2, targets.normal, normalFormat);
+        pass.execute([this, fused, dirtyOnly] {
+            Shader& shader = fused ? normalShader : renderShader;
+            shader.use();
+            shader.setVec4("backgroundColor",
+                renderSettingsData.backgroundColor.r,
+                renderSettingsData.backgroundColor.g,
+                renderSettingsData.backgroundColor.b,
+                renderSettingsData.backgroundColor.a);
+            shader.setFloat("time", renderTime());
+            shader.setBool("dirtyOnly", dirtyOnly);
+
+            dispatchRegion(shader, Kernel::Render, litCells.x0, litCells.y0, litCells.x1, litCells.y1);
+        });
+    }
+
+    // Pass 2: Lighting
+    if (renderSettingsData.occupancySkipping) {
+        buildOccupancy();
+    }
+
+    FrameResource finalLightmap = (renderSettingsData.lightingModel == LightingModel::RadianceCascades)
+        ? renderRadianceCascades()
+        : renderBounceLighting(dirtyOnly);
+    if (renderSettingsData.lightingModel != LightingModel::Bounce) {
+        temporalHistoryValid = false;
+    }
+
+    // Majority-element pyramid for overview levels and the minimap
+    int pyramidLevels = std::max(overviewLevel, renderSettingsData.minimap ? minimapLevel : 0);
+    if (pyramidLevels > 0) {
+        buildOverview(pyramidLevels);
+    }
+    if (renderSettingsData.minimap) {
+        renderMinimap();
+    }
+
+    // Pass 3: Composite
+    // binding 0: stateIn (or the overview level)
+    // binding 1: colorIn (split path only)
+    // binding 2: normalIn (split path only)
+    // binding 3: lightmapIn
+    // binding 4: displayOut
+    auto composite = frameGraph.addPass("composite");
+    if (overviewLevel > 0) {
+        composite.read(0, targets.overview, GL_RGBA8UI, overviewLevel - 1);
+    } else {
+        composite.read(0, targets.state, GL_RGBA8UI);
+    }
+    if (!fused) {
+        composite.read(1, targets.color, GL_RGBA8);
+        composite.read(2, targets.normal, normalFormat);
+    }
+    composite.read(3, finalLightmap, lightmapFormat);
+    composite.write(4, targets.display, displayFormat);
+    bool overlay = renderSettingsData.activityOverlay != ActivityOverlay::Off;
+    if (overlay) {
+        composite.sample(5, targets.activityHeat);
+    }
+    composite.execute([this, fused, dirtyOnly, overlay] {
+        Shader& shader = overlay ? (fused ? fusedOverlayCompositeShader : overlayCompositeShader)
+                                 : (fused ? fusedCompositeShader : compositeShader);
+        shader.use();
+        shader.setFloat("ambientLight", renderSettingsData.ambientLight);
+        shader.setFloat("specularStrength", renderSettingsData.specularStrength);
+        shader.setFloat("time", renderTime());
+        shader.setInt("lightingDownsample", lightingDownsample);
+        shader.setBool("dirtyOnly", dirtyOnly);
+        shader.setIVec2("renderSize", renderWidth, renderHeight);
+        shader.setFloat("renderScale", shownStats.renderScale);
+        shader.setInt("overviewLevel", overviewLevel);
+        shader.setInt("activityOverlay", static_cast<int>(renderSettingsData.activityOverlay));
+        if (fused) {
+            shader.setVec4("backgroundColor",
+                renderSettingsData.backgroundColor.r,
+                renderSettingsData.backgroundColor.g,
+                renderSettingsData.backgroundColor.b,
+                renderSettingsData.backgroundColor.a);
+        }
+
+        // Display texels covering the visible cells
+        float scale = compositeScale();
+        dispatchRegion(shader, Kernel::Composite,
+            static_cast<int>(std::floor(static_cast<float>(visibleCells.x0) * scale)),
+            static_cast<int>(std::floor(static_cast<float>(visibleCells.y0) * scale)),
+            std::min(static_cast<int>(std::ceil(static_cast<float>(visibleCells.x1) * scale)), renderWidth),
+            std::min(static_cast<int>(std::ceil(static_cast<float>(visibleCells.y1) * scale)), renderHeight));
+    });
+
+    frameGraph.execute();
+}
+
+void World::declareFrameTargets(bool needColor, bool needNormals) {
+    frameGraph.beginFrame(frameSlot);
+    targets = FrameTargets();
+
+    targets.state = frameGraph.importTexture("state", renderState());
+    targets.lightmap = frameGraph.importTexture("lightmap", lightmapTexture);
+    targets.lightHistory = frameGraph.importTexture("lightHistory", lightHistoryTexture);
+    targets.display = frameGraph.importTexture("display", displayTexture);
+    targets.occupancy = frameGraph.importTexture("occupancy", occupancyTexture);
+    targets.overview = frameGraph.importTexture("overview", overviewTexture);
+    targets.minimap = frameGraph.importTexture("minimap", minimapTexture);
+    targets.shadowMap = frameGraph.importTexture("shadowMap", shadowMapTexture);
+    targets.shadowLights = frameGraph.importBuffer("shadowLights", shadowLightBuffer);
+    targets.lightCandidates = frameGraph.importBuffer("lightCandidates", lightCandidateBuffer);
+    targets.temporalTiles = frameGraph.importBuffer("temporalTiles", temporalTileBuffer);
+    targets.activityHeat = frameGraph.importTexture("activityHeat", renderHeat());
+
+    // Persistent textures exist while dirty-tile frames build on them (see updateRenderTargets)
+    if (needColor) {
+        targets.color = colorTexture
+            ? frameGraph.importTexture("color", colorTexture)
+            : frameGraph.createTexture("color", {worldWidth, worldHeight, GL_RGBA8});
+    }
+    if (needNormals) {
+        targets.normal = normalTexture
+            ? frameGraph.importTexture("normal", normalTexture)
+            : frameGraph.createTexture("normal", {worldWidth, worldHeight, normalFormat});
+    }
+    targets.lightmapPingPong = lightmapPingPong
+        ? frameGraph.importTexture("lightmapPingPong", lightmapPingPong)
+        : frameGraph.createTexture("lightmapPingPong", {lightmapWidth, lightmapHeight, lightmapFormat, GL_LINEAR});
+}
+
+FrameResource World::renderBounceLighting(bool dirtyOnly) {
+    bool shadowMaps = renderSettingsData.shadowMaps && renderSettingsData.glowEnabled;
+    if (shadowMaps) {
+        renderShadowMaps();
+    }
+
+    // Temporal: relight 1/temporalSlices of the tiles plus any whose elements changed
+    bool temporal = renderSettingsData.temporalLighting;
+    bool temporalReset = !temporalHistoryValid || lightingInputsChanged(temporalSettings, renderSettingsData);
+    int temporalDilation = 1;
+    if (temporal) {
+        // Dilate invalidation by the furthest a changed cell can throw light
+        float tileCells = static_cast<float>(TEMPORAL_TILE_SIZE * lightingDownsample);
+        temporalDilation = std::clamp(static_cast<int>(std::ceil(lightReach() / tileCells)), 1, 2);
+
+        updateTemporalTiles(temporalReset, temporalDilation);
+    }
+    // Passes run after resolveTemporalLighting() has advanced the frame
+    int frame = temporalFrame;
+
+    // Lightmap texels under the lit cells. Temporal tiles are numbered by workgroup
+    // across the whole lightmap, so temporal lighting is never culled.
+    int lightX0 = 0;
+    int lightY0 = 0;
+    int lightX1 = lightmapWidth;
+    int lightY1 = lightmapHeight;
+    if (!temporal) {
+        lightX0 = litCells.x0 / lightingDownsample;
+        lightY0 = litCells.y0 / lightingDownsample;
+        lightX1 = (litCells.x1 + lightingDownsample - 1) / lightingDownsample;
+        lightY1 = (litCells.y1 + lightingDownsample - 1) / lightingDownsample;
+    }
+
+    int bounces = bounceCount();
+    for (int bounce = 0; bounce < bounces; bounce++) {
+        // Read from state + normals, ping-pong lightmaps
+        FrameResource readLight  = (bounce % 2 == 0) ? targets.lightmap : targets.lightmapPingPong;
+        FrameResource writeLight = (bounce % 2 == 0) ? targets.lightmapPingPong : targets.lightmap;
+
+        // binding 0: stateIn
+        // binding 1: normalIn
+        // binding 3: lightIn (read from previous bounce, or empty on first)
+        // binding 4: lightOut (write)
+        // binding 5: shadowMapIn, SSBO 3: shadow-mapped lights, SSBO 5: temporal tiles
+        // texture 0: occupancyMap
+        auto pass = frameGraph.addPass("bounce");
+        pass.read(0, targets.state, GL_RGBA8UI)
+            .read(1, targets.normal, normalFormat)
+            .read(3, readLight, lightmapFormat)
+            .write(4, writeLight, lightmapFormat)
+            .sample(0, targets.occupancy);
+        if (shadowMaps) {
+            pass.read(5, targets.shadowMap, GL_R32F).storage(3, targets.shadowLights, false);
+        }
+        if (temporal) {
+            pass.storage(5, targets.temporalTiles, false);
+        }
+        pass.execute([=, this] {
+            lightingShader.use();
+            if (bounce == 0) {
+                lightingShader.setBool("glowEnabled", renderSettingsData.glowEnabled);
+                lightingShader.setFloat("glowIntensity", renderSettingsData.glowIntensity);
+                lightingShader.setFloat("glowRadius", renderSettingsData.glowRadius);
+                lightingShader.setFloat("time", renderTime());
+                lightingShader.setFloat("ambientLight", renderSettingsData.ambientLight);
+                lightingShader.setBool("shadowMapsEnabled", shadowMaps);
+                lightingShader.setBool("useOccupancy", renderSettingsData.occupancySkipping);
+                lightingShader.setInt("occupancyLevels", occupancyLevels);
+                lightingShader.setInt("lightingDownsample", lightingDownsample);
+                lightingShader.setBool("dirtyOnly", dirtyOnly);
+                lightingShader.setBool("temporalEnabled", temporal);
+                lightingShader.setInt("temporalSlices", std::clamp(renderSettingsData.temporalSlices, 1, MAX_TEMPORAL_SLICES));
+                lightingShader.setInt("temporalFrame", frame);
+                lightingShader.setInt("temporalDilation", temporalDilation);
+                lightingShader.setBool("temporalReset", temporalReset);
+            }
+            lightingShader.setInt("bouncePass", bounce);
+
+            dispatchRegion(lightingShader, WorkgroupSize{TEMPORAL_TILE_SIZE, TEMPORAL_TILE_SIZE},
+                           lightX0, lightY0, lightX1, lightY1);
+        });
+    }
+
+    // Determine which lightmap has the final result
+    // If bounces == 0, we never ran the loop, use lightmapTexture as empty fallback
+    FrameResource finalLightmap = (bounces % 2 == 0) ? targets.lightmap : targets.lightmapPingPong;
+
+    if (!temporal) {
+        temporalHistoryValid = false;
+        return finalLightmap;
+    }
+
+    return resolveTemporalLighting(finalLightmap, temporalReset, temporalDilation);
+}
+
+float World::renderTime() const {
+    // Frozen time keeps shimmer, sparkle and flicker still so static tiles stay clean
+    return renderSettingsData.animatedEffects ? shownTime : 0.0f;
+}
+
+float World::lightReach() const {
+    // Furthest a cell can affect the lightmap: emitter search radius plus bounce spread
+    return std::max(renderSettingsData.glowRadius * 1.5f, 20.0f)
+         + static_cast<float>(bounceCount() * lightingDownsample);
+}
+
+bool World::prepareDirtyTiles() {
+    const RenderSettings& settings = renderSettingsData;
+    bool reuse = persistentTargets() && displayValid && !displayInputsChanged(displaySettings, settings);
+
+    // Whatever happens, this frame consumes the accumulated tiles
+    if (!reuse) {
+        glClearNamedBufferData(dirtyTileBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+        displayValid = true;
+        displaySettings = settings;
+        return false;
+    }
+
+    // Grow dirty tiles by the light reach (+1 for normal gradients and upsampling taps)
+    // SSBO 6: dirty tiles (read), SSBO 7: tiles to render (write)
+    glClearNamedBufferData(renderTileBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, dirtyTileBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 7, renderTileBuffer);
+
+    dirtyDilateShader.use();
+    dirtyDilateShader.setIVec2("worldSize", worldWidth, worldHeight);
+    dirtyDilateShader.setInt("dilation", static_cast<int>(std::ceil(lightReach() / DIRTY_TILE_SIZE)) + 1);
+
+    glDispatchCompute(workgroupCount(dirtyTilesX, DEFAULT_WORKGROUP.x), workgroupCount(dirtyTilesY, DEFAULT_WORKGROUP.y), 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    glClearNamedBufferData(dirtyTileBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+    // Render passes read their mask through SSBO 6
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, renderTileBuffer);
+    return true;
+}
+
+void World::updateTemporalTiles(bool reset, int dilation) {
+    // binding 0: stateIn, SSBO 5: temporal tiles
+    int frame = temporalFrame;
+    frameGraph.addPass("temporal tiles")
+        .read(0, targets.state, GL_RGBA8UI)
+        .storage(5, targets.temporalTiles, true)
+        .execute([this, reset, dilation, frame] {
+            temporalTilesShader.use();
+            temporalTilesShader.setInt("lightingDownsample", lightingDownsample);
+            temporalTilesShader.setInt("temporalSlices", std::clamp(renderSettingsData.temporalSlices, 1, MAX_TEMPORAL_SLICES));
+            temporalTilesShader.setInt("temporalFrame", frame);
+            temporalTilesShader.setInt("temporalDilation", dilation);
+            temporalTilesShader.setBool("temporalReset", reset);
+
+            glDispatchCompute(temporalTilesX, temporalTilesY, 1);
+        });
+}
+
+FrameResource World::resolveTemporalLighting(FrameResource freshLightmap, bool reset, int dilation) {
+    // binding 3: lightIn (this frame's bounce result)
+    // binding 4: historyOut (read + write)
+    // SSBO 5: temporal tiles
+    int frame = temporalFrame;
+    frameGraph.addPass("temporal resolve")
+        .read(3, freshLightmap, lightmapFormat)
+        .readWrite(4, targets.lightHistory, lightmapFormat)
+        .storage(5, targets.temporalTiles, false)
+        .execute([this, reset, dilation, frame] {
+            temporalResolveShader.use();
+            temporalResolveShader.setInt("temporalSlices", std::clamp(renderSettingsData.temporalSlices, 1, MAX_TEMPORAL_SLICES));
+            temporalResolveShader.setInt("temporalFrame", frame);
+            temporalResolveShader.setInt("temporalDilation", dilation);
+            temporalResolveShader.setBool("temporalReset", reset);
+            temporalResolveShader.setFloat("temporalBlend", std::clamp(renderSettingsData.temporalBlend, 0.05f, 1.0f));
+
+            glDispatchCompute(temporalTilesX, temporalTilesY, 1);
+        });
+
+    temporalFrame++;
+    temporalHistoryValid = true;
+    temporalSettings = renderSettingsData;
+
+    return targets.lightHistory;
+}
+
+void World::buildOccupancy() {
+    // binding 0: stateIn
+    // binding 1: occupancyIn (level - 1)
+    // binding 2: occupancyOut (level)
+    // Ray-marches then read the pyramid through texelFetch
+    for (int level = 0; level < occupancyLevels; level++) {
+        auto pass = frameGraph.addPass("occupancy");
+        pass.read(0, targets.state, GL_RGBA8UI);
+        if (level > 0) {
+            pass.read(1, targets.occupancy, GL_RG16F, level - 1);
+        }
+        pass.write(2, targets.occupancy, GL_RG16F, level);
+
+        int levelWidth = occupancyWidth >> level;
+        int levelHeight = occupancyHeight >> level;
+        pass.execute([this, level, levelWidth, levelHeight] {
+            occupancyShader.use();
+            occupancyShader.setInt("level", level);
+            glDispatchCompute(workgroupCount(levelWidth, DEFAULT_WORKGROUP.x), workgroupCount(levelHeight, DEFAULT_WORKGROUP.y), 1);
+        });
+    }
+}
+
+void World::renderShadowMaps() {
+    // Pass A: Strong emitters -> one candidate light per block
+    // binding 0: stateIn, SSBO 3: selected lights, SSBO 4: candidates
+    frameGraph.addPass("shadow gather")
+        .read(0, targets.state, GL_RGBA8UI)
+        .storage(3, targets.shadowLights, true)
+        .storage(4, targets.lightCandidates, true)
+        .execute([this] {
+            // Reset selected light and candidate counts
+            glClearNamedBufferSubData(shadowLightBuffer, GL_R32I, 0, 2 * sizeof(int), GL_RED_INTEGER, GL_INT, nullptr);
+
+            shadowGatherShader.use();
+            shadowGatherShader.setFloat("glowIntensity", renderSettingsData.glowIntensity);
+            shadowGatherShader.setFloat("glowRadius", renderSettingsData.glowRadius);
+            shadowGatherShader.setFloat("time", renderTime());
+
+            GLuint blocksX = (worldWidth + LIGHT_BLOCK_SIZE - 1) / LIGHT_BLOCK_SIZE;
+            GLuint blocksY = (worldHeight + LIGHT_BLOCK_SIZE - 1) / LIGHT_BLOCK_SIZE;
+            glDispatchCompute(workgroupCount(blocksX, DEFAULT_WORKGROUP.x), workgroupCount(blocksY, DEFAULT_WORKGROUP.y), 1);
+        });
+
+    // Pass B: Keep the brightest candidates
+    frameGraph.addPass("shadow select")
+        .storage(3, targets.shadowLights, true)
+        .storage(4, targets.lightCandidates, false)
+        .execute([this] {
+            shadowSelectShader.use();
+            shadowSelectShader.setInt("maxLights", std::clamp(renderSettingsData.shadowMapLights, 0, MAX_SHADOW_LIGHTS));
+            glDispatchCompute(1, 1, 1);
+        });
+
+    // Pass C: Unwrap occluders around each light into a polar depth row
+    // binding 5: shadowMapOut (R32F, write)
+    frameGraph.addPass("shadow map")
+        .read(0, targets.state, GL_RGBA8UI)
+        .storage(3, targets.shadowLights, false)
+        .write(5, targets.shadowMap, GL_R32F)
+        .execute([this] {
+            shadowMapShader.use();
+            shadowMapShader.setFloat("glowIntensity", renderSettingsData.glowIntensity);
+            shadowMapShader.setFloat("glowRadius", renderSettingsData.glowRadius);
+            shadowMapShader.setFloat("time", renderTime());
+
+            glDispatchCompute(SHADOW_MAP_RESOLUTION, MAX_SHADOW_LIGHTS, 1);
+        });
+}
+
+int World::resolveCascadeCount() const {
+    if (renderSettingsData.cascadeCount > 0) {
+        return std::min(renderSettingsData.cascadeCount, MAX_CASCADES);
+    }
+
+    // Smallest count whose last interval reaches across the whole world:
+    // cascade c ends at b * (4^(c+1) - 1) / 3
+    float diagonal = std::sqrt(static_cast<float>(worldWidth * worldWidth + worldHeight * worldHeight));
+    float base = std::max(renderSettingsData.cascadeInterval, 0.5f);
+    int count = 1;
+    while (count < MAX_CASCADES && base * (std::pow(4.0f, static_cast<float>(count)) - 1.0f) / 3.0f < diagonal) {
+        count++;
+    }
+    return count;
+}
+
+FrameResource World::renderRadianceCascades() {
+    if (!renderSettingsData.glowEnabled) {
+        frameGraph.addPass("clear lightmap")
+            .write(5, targets.lightmap, lightmapFormat)
+            .execute([this] { glClearTexImage(lightmapTexture, 0, GL_RGBA, GL_FLOAT, nullptr); });
+        return targets.lightmap;
+    }
+
+    int cascades = resolveCascadeCount();
+
+    // Every cascade fills the same padded texture, so the dispatch size is fixed
+    TextureDesc cascadeDesc{cascadeWidth, cascadeHeight, GL_RGBA16F};
+    WorkgroupSize cascadeGroup = workgroup(Kernel::Cascades);
+    GLuint cascadeGroupsX = workgroupCount(cascadeWidth, cascadeGroup.x);
+    GLuint cascadeGroupsY = workgroupCount(cascadeHeight, cascadeGroup.y);
+
+    // Top cascade first, each lower cascade merges the one above it. A cascade is dead
+    // once the next one down has merged it, so two pooled textures back them all.
+    // binding 0: stateIn
+    // binding 3: cascadeIn (cascade c+1)
+    // binding 4: cascadeOut (cascade c)
+    // texture 0: occupancyMap
+    FrameResource upper = -1;
+    for (int c = cascades - 1; c >= 0; c--) {
+        FrameResource cascade = frameGraph.createTexture("cascade", cascadeDesc);
+        auto pass = frameGraph.addPass("cascade");
+        pass.read(0, targets.state, GL_RGBA8UI)
+            .sample(0, targets.occupancy)
+            .write(4, cascade, GL_RGBA16F);
+        // The top cascade has nothing above it to merge
+        if (c < cascades - 1) pass.read(3, upper, GL_RGBA16F);
+        pass.execute([this, c, cascades, cascadeGroupsX, cascadeGroupsY] {
+            cascadeShader.use();
+            if (c == cascades - 1) {
+                cascadeShader.setFloat("glowIntensity", renderSettingsData.glowIntensity);
+                cascadeShader.setFloat("glowRadius", renderSettingsData.glowRadius);
+                cascadeShader.setFloat("time", renderTime());
+                cascadeShader.setIVec2("cascadeSize", cascadeWidth, cascadeHeight);
+                cascadeShader.setInt("cascadeCount", cascades);
+                cascadeShader.setFloat("intervalBase", std::max(renderSettingsData.cascadeInterval, 0.5f));
+                cascadeShader.setFloat("emissionScale", renderSettingsData.cascadeEmission);
+                cascadeShader.setBool("integratePass", false);
+                cascadeShader.setBool("useOccupancy", renderSettingsData.occupancySkipping);
+                cascadeShader.setInt("occupancyLevels", occupancyLevels);
+                cascadeShader.setInt("lightingDownsample", lightingDownsample);
+            }
+            cascadeShader.setInt("cascadeIndex", c);
+
+            dispatchKernel(Kernel::Cascades, cascadeGroupsX, cascadeGroupsY);
+        });
+        upper = cascade;
+    }
+
+    // Integrate cascade 0 into the lightmap
+    // binding 5: lightmapOut
+    frameGraph.addPass("cascade integrate")
+        .read(0, targets.state, GL_RGBA8UI)
+        .sample(0, targets.occupancy)
+        .read(3, upper, GL_RGBA16F)
+        .write(5, targets.lightmap, lightmapFormat)
+        .execute([this, cascadeGroup] {
+            cascadeShader.use();
+            cascadeShader.setBool("integratePass", true);
+            dispatchKernel(Kernel::Cascades, workgroupCount(lightmapWidth, cascadeGroup.x), workgroupCount(lightmapHeight, cascadeGroup.y));
+        });
+
+    return targets.lightmap;
+}
+
 void World::swapBuffers() {
     currentBuffer = 1 - currentBuffer;
 }